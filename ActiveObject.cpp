@@ -1,43 +1,194 @@
 #include "ActiveObject.hpp"
+#include "futex.hpp"
+#include <chrono>
+#include <mutex>
+#include <vector>
 
-ActiveObject::ActiveObject() : stopFlag(false) {
+namespace {
+
+// Empty polls (with a yield between) before the worker goes to sleep. On a
+// single CPU the producer cannot run while the worker spins, so sleep at once.
+const int SPIN_ROUNDS = std::thread::hardware_concurrency() > 1 ? 64 : 0;
+
+// Free nodes a thread keeps for reuse; beyond that, returned nodes are freed
+const size_t MAX_CACHED_NODES = 1024;
+
+} // namespace
+
+// Per-thread pool of task nodes. Only the owning thread takes nodes out;
+// workers on any thread push finished nodes onto returned. A cache is never
+// freed, since nodes may still be on their way back to it: when its thread
+// exits it is parked on an orphan list and adopted by the next new thread.
+struct ActiveObject::NodeCache {
+    MPSCQueue<TaskNode> returned;
+    TaskNode* freeList = nullptr; // Owner only, linked through next
+    size_t freeCount = 0;
+};
+
+ActiveObject::NodeCache& ActiveObject::localCache() {
+    static std::mutex orphansMutex;
+    static std::vector<NodeCache*>* orphans = new std::vector<NodeCache*>(); // Leaked: outlives thread exit
+
+    struct Handle {
+        NodeCache* cache;
+        Handle() {
+            std::lock_guard<std::mutex> lock(orphansMutex);
+            if (orphans->empty()) {
+                cache = new NodeCache();
+            } else {
+                cache = orphans->back();
+                orphans->pop_back();
+            }
+        }
+        ~Handle() {
+            std::lock_guard<std::mutex> lock(orphansMutex);
+            orphans->push_back(cache);
+        }
+    };
+    thread_local Handle handle;
+    return *handle.cache;
+}
+
+ActiveObject::TaskNode* ActiveObject::allocateNode() {
+    NodeCache& cache = localCache();
+    if (cache.freeList == nullptr) {
+        // Take back what the workers have finished with
+        while (TaskNode* node = cache.returned.pop()) {
+            if (cache.freeCount >= MAX_CACHED_NODES) {
+                delete node;
+                continue;
+            }
+            node->next.store(cache.freeList, std::memory_order_relaxed);
+            cache.freeList = node;
+            ++cache.freeCount;
+        }
+    }
+
+    if (TaskNode* node = cache.freeList) {
+        cache.freeList = node->next.load(std::memory_order_relaxed);
+        --cache.freeCount;
+        return node;
+    }
+    TaskNode* node = new TaskNode();
+    node->home = &cache;
+    return node;
+}
+
+void ActiveObject::recycleNode(TaskNode* node) {
+    node->task.reset(); // Release the captures now, not when the node is reused
+    node->home->returned.push(node);
+}
+
+ActiveObject::ActiveObject(size_t capacity)
+    : capacity(capacity), sleeping(0), stopFlag(false), depth(0), peakDepth(0), spaceEpoch(0),
+      waitingProducers(0), blockedCount(0), blockedNanos(0) {
     // Start the worker thread that will process tasks
     workerThread = std::thread(&ActiveObject::processTasks, this);
 }
 
 ActiveObject::~ActiveObject() {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        stopFlag = true;
-    }
-    condition.notify_all(); // Wake up the worker thread to exit
+    stopFlag.store(true, std::memory_order_seq_cst);
+    wakeWorker(); // Wake up the worker thread to exit
     if (workerThread.joinable()) {
         workerThread.join();
     }
 }
 
-void ActiveObject::enqueueTask(std::function<void()> task) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        taskQueue.push(std::move(task)); // Push the task into the queue
+void ActiveObject::enqueueTask(InlineTask task) {
+    reserveSlot();
+    TaskNode* node = allocateNode();
+    node->task = std::move(task);
+    taskQueue.push(node); // Push the task into the queue
+    wakeWorker(); // Notify the worker thread if it went to sleep
+}
+
+ActiveObject::Stats ActiveObject::stats() const {
+    return Stats{capacity, depth.load(std::memory_order_relaxed), peakDepth.load(std::memory_order_relaxed),
+                 blockedCount.load(std::memory_order_relaxed), blockedNanos.load(std::memory_order_relaxed)};
+}
+
+void ActiveObject::reserveSlot() {
+    std::chrono::steady_clock::time_point blockedSince;
+    bool blocked = false;
+
+    size_t current = capacity == 0 ? depth.fetch_add(1, std::memory_order_relaxed) : depth.load(std::memory_order_relaxed);
+    while (capacity > 0) {
+        if (current < capacity) {
+            if (depth.compare_exchange_weak(current, current + 1, std::memory_order_seq_cst)) break;
+            continue;
+        }
+
+        if (!blocked) {
+            blocked = true;
+            blockedSince = std::chrono::steady_clock::now();
+        }
+        // Same announce-then-recheck handshake as the worker's sleep
+        uint32_t key = spaceEpoch.load(std::memory_order_seq_cst);
+        waitingProducers.fetch_add(1, std::memory_order_seq_cst);
+        if (depth.load(std::memory_order_seq_cst) >= capacity) {
+            futexWait(spaceEpoch, key);
+        }
+        waitingProducers.fetch_sub(1, std::memory_order_seq_cst);
+        current = depth.load(std::memory_order_relaxed);
+    }
+
+    size_t peak = peakDepth.load(std::memory_order_relaxed);
+    while (current + 1 > peak && !peakDepth.compare_exchange_weak(peak, current + 1, std::memory_order_relaxed)) {
+    }
+    if (blocked) {
+        auto waited = std::chrono::steady_clock::now() - blockedSince;
+        blockedCount.fetch_add(1, std::memory_order_relaxed);
+        blockedNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count(),
+                               std::memory_order_relaxed);
+    }
+}
+
+void ActiveObject::releaseSlot() {
+    depth.fetch_sub(1, std::memory_order_seq_cst);
+    if (waitingProducers.load(std::memory_order_seq_cst) > 0) {
+        spaceEpoch.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(spaceEpoch, 1);
+    }
+}
+
+void ActiveObject::wakeWorker() {
+    // Pairs with processTasks: either the worker sees the new task (or the
+    // stop flag) after announcing sleep, or this thread sees the announcement
+    if (sleeping.load(std::memory_order_seq_cst) == 1 && sleeping.exchange(0, std::memory_order_seq_cst) == 1) {
+        futexWake(sleeping, 1);
     }
-    condition.notify_one(); // Notify the worker thread that a new task is available
 }
 
 void ActiveObject::processTasks() {
+    int idleRounds = 0;
     while (true) {
-        std::function<void()> task;
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            condition.wait(lock, [this] { return !taskQueue.empty() || stopFlag; });
+        if (TaskNode* node = taskQueue.pop()) {
+            releaseSlot();
+            node->task(); // Execute the task
+            recycleNode(node);
+            idleRounds = 0;
+            continue;
+        }
 
-            if (stopFlag && taskQueue.empty()) {
-                return; // Exit the loop if stopFlag is set and there are no tasks left
-            }
+        if (taskQueue.hasPending()) {
+            std::this_thread::yield(); // A producer is between its two stores
+            continue;
+        }
+        if (stopFlag.load(std::memory_order_acquire)) {
+            return; // Exit the loop if stopFlag is set and there are no tasks left
+        }
+        if (idleRounds++ < SPIN_ROUNDS) {
+            std::this_thread::yield();
+            continue;
+        }
+        idleRounds = 0;
 
-            task = std::move(taskQueue.front());
-            taskQueue.pop();
+        sleeping.store(1, std::memory_order_seq_cst);
+        if (taskQueue.hasPending() || stopFlag.load(std::memory_order_seq_cst)) {
+            sleeping.store(0, std::memory_order_relaxed);
+            continue;
         }
-        task(); // Execute the task outside the locked region
+        futexWait(sleeping, 1);
+        sleeping.store(0, std::memory_order_relaxed);
     }
-}
\ No newline at end of file
+}
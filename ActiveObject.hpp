@@ -1,29 +1,81 @@
 #ifndef ACTIVE_OBJECT_HPP
 #define ACTIVE_OBJECT_HPP
 
-#include <queue>
+#include "inline_task.hpp"
+#include "mpsc_queue.hpp"
 #include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <functional>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 
+// One worker thread running tasks in the order they were enqueued. Producers
+// push onto a lock-free MPSC queue; the worker spins briefly when the queue
+// runs dry and then sleeps on a futex, which a producer only has to wake
+// when the worker has announced that it is going to sleep.
+//
+// With a capacity, enqueueTask blocks while that many tasks are waiting, so
+// a slow stage pushes back on the stages feeding it instead of letting its
+// queue grow without bound. A bounded ActiveObject must never enqueue onto
+// itself, or it could wait for its own worker.
+//
+// Enqueueing does not allocate: the task is stored inline in a queue node,
+// and nodes are recycled through a cache owned by the enqueueing thread,
+// which the worker hands each node back to once its task has run.
 class ActiveObject {
 public:
-    ActiveObject();
+    // capacity == 0: unbounded
+    explicit ActiveObject(size_t capacity = 0);
     ~ActiveObject();
 
-    // Enqueue a new task (a function) to be processed by the ActiveObject's thread
-    void enqueueTask(std::function<void()> task);
+    // Enqueue a new task (a function) to be processed by the ActiveObject's
+    // thread, first waiting for room if the queue is full
+    void enqueueTask(InlineTask task);
+
+    // True if enqueueTask would not wait right now. Only a queue's sole
+    // producer can rely on it; other producers may take the room first.
+    bool hasRoom() const { return capacity == 0 || depth.load(std::memory_order_seq_cst) < capacity; }
+
+    struct Stats {
+        size_t capacity;       // 0: unbounded
+        size_t depth;          // Tasks waiting right now
+        size_t peakDepth;      // Most tasks ever waiting at once
+        uint64_t blockedCount; // enqueueTask calls that had to wait for room
+        uint64_t blockedNanos; // Total time those calls waited
+    };
+    Stats stats() const;
 
 private:
+    struct NodeCache;
+
+    struct TaskNode {
+        std::atomic<TaskNode*> next;
+        InlineTask task;
+        NodeCache* home; // Cache of the thread that allocated the node
+    };
+
+    static NodeCache& localCache();
+    static TaskNode* allocateNode();
+    static void recycleNode(TaskNode* node);
+
     void processTasks(); // Method for the worker thread to process the tasks
+    void wakeWorker();
+    void reserveSlot();
+    void releaseSlot();
 
-    std::queue<std::function<void()>> taskQueue;
-    std::mutex queueMutex;
-    std::condition_variable condition;
+    const size_t capacity;
+    MPSCQueue<TaskNode> taskQueue;
+    std::atomic<uint32_t> sleeping; // Futex word: 1 while the worker may be asleep
     std::thread workerThread;
     std::atomic<bool> stopFlag;
+
+    // Backpressure: producers waiting for room sleep on spaceEpoch, which the
+    // worker bumps after taking a task while any producer waits
+    std::atomic<size_t> depth;
+    std::atomic<size_t> peakDepth;
+    std::atomic<uint32_t> spaceEpoch;
+    std::atomic<uint32_t> waitingProducers;
+    std::atomic<uint64_t> blockedCount;
+    std::atomic<uint64_t> blockedNanos;
 };
 
-#endif // ACTIVE_OBJECT_HPP
\ No newline at end of file
+#endif // ACTIVE_OBJECT_HPP
@@ -0,0 +1,188 @@
+// alloc_bench.cpp
+//
+// Counts heap allocations per "add" command through the whole mst_solver
+// pipeline (reactor, command parsing, graph update, ordered response).
+//
+//   alloc_bench [adds] [port]
+//
+// The server runs in this process with the global operator new replaced by
+// a counting one. A client on another thread creates a graph, warms up, and
+// then sends adds twice: lockstep (each reply awaited before the next add)
+// and pipelined (all adds in one burst). The client only uses buffers set up
+// before measuring, so every counted allocation is the server's.
+
+#include "logger.hpp"
+#include "server.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+} // namespace
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+const int VERTICES = 1000;
+
+class Client {
+public:
+    explicit Client(int port) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        // The server thread may still be binding
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) break;
+            close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        if (fd < 0) {
+            std::perror("connect");
+            std::exit(1);
+        }
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    }
+
+    ~Client() { close(fd); }
+
+    void send(const char* data, size_t size) {
+        for (size_t sent = 0; sent < size;) {
+            ssize_t n = ::send(fd, data + sent, size - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                std::perror("send");
+                std::exit(1);
+            }
+            sent += n;
+        }
+    }
+
+    // Read until count more reply lines have arrived
+    void awaitLines(size_t count) {
+        while (count > 0) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                std::fprintf(stderr, "connection closed by server\n");
+                std::exit(1);
+            }
+            for (ssize_t i = 0; i < n; ++i) {
+                if (buffer[i] == '\n') --count;
+            }
+        }
+    }
+
+private:
+    int fd = -1;
+    char buffer[64 * 1024];
+};
+
+// "add v w weight\n" lines with random endpoints, one string per command
+std::vector<std::string> makeAdds(int count, std::mt19937& rng) {
+    std::uniform_int_distribution<int> vertex(0, VERTICES - 1);
+    std::uniform_int_distribution<int> weight(1, 1000);
+    std::vector<std::string> adds;
+    adds.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        adds.push_back("add " + std::to_string(vertex(rng)) + " " + std::to_string(vertex(rng)) + " " +
+                       std::to_string(weight(rng)) + "\n");
+    }
+    return adds;
+}
+
+void report(const char* mode, int adds, uint64_t counted) {
+    std::printf("%-9s %d adds, %llu allocations, %.2f per add\n", mode, adds,
+                static_cast<unsigned long long>(counted), static_cast<double>(counted) / adds);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int adds = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int port = argc > 2 ? std::atoi(argv[2]) : 12399;
+    if (adds < 1 || port <= 0) {
+        std::fprintf(stderr, "Usage: %s [adds] [port]\n", argv[0]);
+        return 1;
+    }
+
+    Logger::instance().setLevel(LogLevel::Error);
+    server srv(port);
+    std::thread serverThread([&srv]() { srv.start(); });
+
+    {
+        std::mt19937 rng(42);
+        std::vector<std::string> warmup = makeAdds(adds, rng);
+        std::vector<std::string> lockstep = makeAdds(adds, rng);
+        std::string burst;
+        for (const std::string& add : makeAdds(adds, rng)) burst += add;
+
+        Client client(port);
+        std::string create = "create " + std::to_string(VERTICES) + " 0\n";
+        client.send(create.data(), create.size());
+        client.awaitLines(1);
+
+        // Grows the edge list and fills the stages' node caches
+        for (const std::string& add : warmup) {
+            client.send(add.data(), add.size());
+            client.awaitLines(1);
+        }
+
+        uint64_t before = allocations.load();
+        for (const std::string& add : lockstep) {
+            client.send(add.data(), add.size());
+            client.awaitLines(1);
+        }
+        report("lockstep", adds, allocations.load() - before);
+
+        before = allocations.load();
+        client.send(burst.data(), burst.size());
+        client.awaitLines(adds);
+        report("pipelined", adds, allocations.load() - before);
+    }
+
+    srv.stop();
+    serverThread.join();
+    return 0;
+}
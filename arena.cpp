@@ -0,0 +1,94 @@
+#include "arena.hpp"
+#include <sys/mman.h>
+#include <cstdint>
+#include <new>
+
+namespace {
+
+// Blocks up to this size are pooled; larger ones (edge arrays, CSR) go to
+// the upstream resource as they are, and back to it when freed
+const size_t LARGEST_POOLED_BLOCK = 64 << 10;
+
+std::pmr::pool_options poolOptions() {
+    std::pmr::pool_options options;
+    options.largest_required_pool_block = LARGEST_POOLED_BLOCK;
+    return options;
+}
+
+size_t roundToHugePages(size_t bytes) {
+    return (bytes + SessionArena::HUGE_PAGE_SIZE - 1) & ~(SessionArena::HUGE_PAGE_SIZE - 1);
+}
+
+// mmap only promises page alignment, and the kernel can only back a range
+// with huge pages where it covers whole aligned 2 MiB frames. Map one huge
+// page extra and unmap the slack on both sides, which leaves exactly
+// [result, result + length) mapped for do_deallocate's munmap.
+void* mapHugePageAligned(size_t length) {
+    size_t mapped = length + SessionArena::HUGE_PAGE_SIZE;
+    void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+
+    char* raw = static_cast<char*>(p);
+    char* aligned = reinterpret_cast<char*>(roundToHugePages(reinterpret_cast<uintptr_t>(raw)));
+    size_t head = aligned - raw;
+    if (head > 0) munmap(raw, head);
+    munmap(aligned + length, mapped - head - length);
+    return aligned;
+}
+
+} // namespace
+
+SessionArena::SessionArena() : SessionArena(Options()) {}
+
+// An unsynchronized pool behind a mutex rather than synchronized_pool_resource:
+// the latter takes a pthread key per instance, and there is one arena per
+// session, which would run out of keys with enough connections
+SessionArena::SessionArena(const Options& options) : upstream(options.hugePages), pool(poolOptions(), &upstream) {}
+
+SessionArena::~SessionArena() {
+    pool.release();
+}
+
+void* SessionArena::do_allocate(size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return pool.allocate(bytes, alignment);
+}
+
+void SessionArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    pool.deallocate(p, bytes, alignment);
+}
+
+bool SessionArena::Upstream::useHugePages(size_t bytes, size_t alignment) const {
+    return hugePages && bytes >= HUGE_PAGE_SIZE && alignment <= HUGE_PAGE_SIZE;
+}
+
+void* SessionArena::Upstream::do_allocate(size_t bytes, size_t alignment) {
+    void* p;
+    if (useHugePages(bytes, alignment)) {
+        size_t length = roundToHugePages(bytes);
+        p = mapHugePageAligned(length);
+        madvise(p, length, MADV_HUGEPAGE); // Advisory: without THP these stay small pages
+        reserved.fetch_add(length, std::memory_order_relaxed);
+    } else {
+        p = alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? ::operator new(bytes)
+                                                          : ::operator new(bytes, std::align_val_t(alignment));
+        reserved.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    return p;
+}
+
+void SessionArena::Upstream::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    if (useHugePages(bytes, alignment)) {
+        size_t length = roundToHugePages(bytes);
+        munmap(p, length);
+        reserved.fetch_sub(length, std::memory_order_relaxed);
+    } else {
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(p, bytes);
+        } else {
+            ::operator delete(p, bytes, std::align_val_t(alignment));
+        }
+        reserved.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+}
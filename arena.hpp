@@ -0,0 +1,66 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+// Memory resource owning everything one session allocates for its graphs:
+// edge lists, CSR arrays, the edge index and solver scratch. Small blocks
+// come from size-class pools carved out of large chunks, so the millions of
+// index nodes of a big graph cost no malloc each and freed blocks are reused
+// in place. Destroying the arena hands all chunks back in one go.
+//
+// Graphs keep their arena alive through a shared_ptr, so a snapshot that
+// outlives its session still has valid memory; the arena is released when
+// the session and every graph built in it are gone. Any thread may use it.
+class SessionArena : public std::pmr::memory_resource {
+public:
+    struct Options {
+        // Back blocks of HUGE_PAGE_SIZE or more with transparent huge pages
+        // (mmap + MADV_HUGEPAGE) instead of the heap, which cuts TLB misses
+        // and page faults when a large session's edge arrays grow
+        bool hugePages = false;
+    };
+
+    static const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+    SessionArena();
+    explicit SessionArena(const Options& options);
+    ~SessionArena() override;
+
+    SessionArena(const SessionArena&) = delete;
+    SessionArena& operator=(const SessionArena&) = delete;
+
+    // Bytes currently taken from the system (pool chunks and large blocks)
+    size_t reservedBytes() const { return upstream.reservedBytes(); }
+
+private:
+    // Where the pools get their chunks and large blocks go directly
+    class Upstream : public std::pmr::memory_resource {
+    public:
+        explicit Upstream(bool hugePages) : hugePages(hugePages) {}
+        size_t reservedBytes() const { return reserved.load(std::memory_order_relaxed); }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        bool useHugePages(size_t bytes, size_t alignment) const;
+
+        const bool hugePages;
+        std::atomic<size_t> reserved{0};
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    Upstream upstream;
+    std::mutex poolMutex;
+    std::pmr::unsynchronized_pool_resource pool; // Guarded by poolMutex
+};
+
+#endif // ARENA_HPP
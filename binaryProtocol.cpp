@@ -0,0 +1,88 @@
+#include "binaryProtocol.hpp"
+#include <cstring>
+
+namespace binaryProtocol {
+
+bool parseHeader(const char* data, FrameHeader& header) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(data);
+    if (b[0] != MAGIC) return false;
+    header.opcode = b[1];
+    header.status = static_cast<uint16_t>(b[2] | (b[3] << 8));
+    header.length = static_cast<uint32_t>(b[4]) | (static_cast<uint32_t>(b[5]) << 8) |
+                    (static_cast<uint32_t>(b[6]) << 16) | (static_cast<uint32_t>(b[7]) << 24);
+    return true;
+}
+
+void Writer::u32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void Writer::u64(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void Writer::f64(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    u64(bits);
+}
+
+bool Reader::u8(uint8_t& value) {
+    if (end - p < 1) return false;
+    value = static_cast<uint8_t>(*p++);
+    return true;
+}
+
+bool Reader::u32(uint32_t& value) {
+    if (end - p < 4) return false;
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    value = static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+            (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+    p += 4;
+    return true;
+}
+
+bool Reader::i32(int32_t& value) {
+    uint32_t raw;
+    if (!u32(raw)) return false;
+    value = static_cast<int32_t>(raw);
+    return true;
+}
+
+std::string frame(uint8_t opcode, uint16_t status, const std::string& payload) {
+    Writer header;
+    header.u8(MAGIC);
+    header.u8(opcode);
+    header.u8(static_cast<uint8_t>(status & 0xFF));
+    header.u8(static_cast<uint8_t>(status >> 8));
+    header.u32(static_cast<uint32_t>(payload.size()));
+    std::string out = std::move(header.str());
+    out += payload;
+    return out;
+}
+
+std::string errorFrame(uint8_t opcode, uint16_t status, const std::string& message) {
+    return frame(opcode | RESPONSE_FLAG, status, message);
+}
+
+std::string solveFrame(const std::vector<Edge>& mstEdges, const MSTStatistics& stats) {
+    Writer payload;
+    payload.str().reserve(32 + mstEdges.size() * 12);
+    payload.i64(stats.totalWeight);
+    payload.i32(stats.longestDistance);
+    payload.i32(stats.shortestDistance);
+    payload.f64(stats.averageDistance);
+    payload.u32(static_cast<uint32_t>(mstEdges.size()));
+    for (const Edge& edge : mstEdges) {
+        payload.u32(static_cast<uint32_t>(edge.v));
+        payload.u32(static_cast<uint32_t>(edge.w));
+        payload.i32(edge.weight);
+    }
+    return frame(OP_SOLVE | RESPONSE_FLAG, STATUS_OK, payload.str());
+}
+
+} // namespace binaryProtocol
@@ -0,0 +1,99 @@
+#ifndef BINARY_PROTOCOL_HPP
+#define BINARY_PROTOCOL_HPP
+
+#include "graph.hpp"
+#include "mst_solver.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Length-prefixed binary protocol, an alternative to the text commands.
+// A connection is binary if its first byte is MAGIC. Every message, in both
+// directions, is an 8-byte header followed by `length` payload bytes; all
+// integers are fixed-width little-endian:
+//
+//   u8 magic (0xB7) | u8 opcode | u16 status | u32 length | payload
+//
+// Requests (status 0):
+//   CREATE  u32 vertices, u32 edges
+//   ADD     u32 v, u32 w, i32 weight
+//   SOLVE   u8 algorithm (MSTAlgorithmType)
+//   REMOVE  u32 v, u32 w
+// Responses echo the opcode with RESPONSE_FLAG set. On STATUS_OK:
+//   CREATE, ADD  empty
+//   REMOVE       u32 number of edges removed
+//   SOLVE        i64 totalWeight, i32 longest, i32 shortest, f64 average,
+//                u32 edgeCount, edgeCount x (u32 v, u32 w, i32 weight)
+// Any other status carries a UTF-8 error message as payload.
+namespace binaryProtocol {
+
+const uint8_t MAGIC = 0xB7;
+const size_t HEADER_SIZE = 8;
+const uint32_t MAX_PAYLOAD = 64u << 20;
+
+enum Opcode : uint8_t {
+    OP_CREATE = 0x01,
+    OP_ADD = 0x02,
+    OP_SOLVE = 0x03,
+    OP_REMOVE = 0x04,
+    RESPONSE_FLAG = 0x80
+};
+
+enum Status : uint16_t {
+    STATUS_OK = 0,
+    STATUS_INVALID_INPUT = 1,
+    STATUS_UNKNOWN_OPCODE = 2,
+    STATUS_OUT_OF_RANGE = 3
+};
+
+struct FrameHeader {
+    uint8_t opcode;
+    uint16_t status;
+    uint32_t length;
+};
+
+// Decode the header at data (HEADER_SIZE bytes); false if the magic is wrong
+bool parseHeader(const char* data, FrameHeader& header);
+
+// Appends little-endian fields to a payload
+class Writer {
+public:
+    void u8(uint8_t value) { out.push_back(static_cast<char>(value)); }
+    void u32(uint32_t value);
+    void i32(int32_t value) { u32(static_cast<uint32_t>(value)); }
+    void u64(uint64_t value);
+    void i64(int64_t value) { u64(static_cast<uint64_t>(value)); }
+    void f64(double value);
+    std::string& str() { return out; }
+
+private:
+    std::string out;
+};
+
+// Reads little-endian fields from a payload; each call fails (returns false)
+// instead of reading past the end
+class Reader {
+public:
+    Reader(const char* data, size_t length) : p(data), end(data + length) {}
+    bool u8(uint8_t& value);
+    bool u32(uint32_t& value);
+    bool i32(int32_t& value);
+    bool atEnd() const { return p == end; }
+
+private:
+    const char* p;
+    const char* end;
+};
+
+// A complete message: header plus payload
+std::string frame(uint8_t opcode, uint16_t status, const std::string& payload);
+
+// Error response for a request opcode
+std::string errorFrame(uint8_t opcode, uint16_t status, const std::string& message);
+
+// SOLVE response payload (wrapped in a frame)
+std::string solveFrame(const std::vector<Edge>& mstEdges, const MSTStatistics& stats);
+
+} // namespace binaryProtocol
+
+#endif // BINARY_PROTOCOL_HPP
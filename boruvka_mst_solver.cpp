@@ -0,0 +1,131 @@
+// boruvka_mst_solver.cpp
+
+#include "boruvka_mst_solver.hpp"
+#include "dsu.hpp"
+#include "edge_sort.hpp"
+#include "scheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+
+namespace {
+
+// Below this many items per worker a round runs on the calling thread
+const size_t MIN_ITEMS_PER_THREAD = 16384;
+
+const uint64_t NO_EDGE = UINT64_MAX;
+
+void atomicMin(std::atomic<uint64_t>& slot, uint64_t key) {
+    uint64_t current = slot.load(std::memory_order_relaxed);
+    while (key < current && !slot.compare_exchange_weak(current, key, std::memory_order_relaxed)) {
+    }
+}
+
+// Split [0, n) into contiguous slices and run fn(slice, begin, end) on each
+// over the shared scheduler's workers
+void parallelFor(unsigned numThreads, size_t n, const std::function<void(size_t, size_t, size_t)>& fn) {
+    size_t slices = std::min<size_t>(numThreads, n / MIN_ITEMS_PER_THREAD);
+    Scheduler::instance().parallelFor(n, slices, fn);
+}
+
+} // namespace
+
+BoruvkaMSTSolver::BoruvkaMSTSolver(unsigned numThreads)
+    : numThreads(numThreads ? numThreads : Scheduler::instance().workerCount()) {}
+
+std::vector<Edge> BoruvkaMSTSolver::solveMST(Graph& graph) {
+    const EdgeArrays& edges = graph.getEdges();
+    int V = graph.getV();
+
+    if (V == 0 || edges.empty()) {
+        return {};
+    }
+
+    // Scratch comes from one buffer in the graph's arena, freed in one go.
+    // The survivor slices are filled by several workers at once, so they use
+    // the (thread-safe) graph resource instead of this single-threaded buffer.
+    std::pmr::monotonic_buffer_resource scratch(edges.size() * sizeof(uint32_t) + V * (3 * sizeof(int) + sizeof(uint64_t)) + 256,
+                                                graph.resource());
+
+    // Edges that may still connect two different components (self-loops never do)
+    std::pmr::vector<uint32_t> alive(&scratch);
+    alive.reserve(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        if (edges.src[i] != edges.dst[i]) alive.push_back(static_cast<uint32_t>(i));
+    }
+
+    DSU dsu(V, &scratch);
+    std::pmr::vector<int> component(V, &scratch);
+    std::pmr::vector<std::atomic<uint64_t>> best(V, &scratch);
+    std::pmr::vector<uint64_t> mstKeys(&scratch);
+    std::pmr::vector<std::pmr::vector<uint32_t>> survivors(numThreads, graph.resource());
+
+    while (!alive.empty()) {
+        for (int u = 0; u < V; ++u) {
+            component[u] = dsu.find(u);
+            best[u].store(NO_EDGE, std::memory_order_relaxed);
+        }
+
+        // Lightest outgoing edge per component, in parallel over the edges.
+        // A weightKey (weight, then index) per edge gives a strict total
+        // order and lets workers publish a component's best edge with a CAS.
+        // Edges inside a component are dropped for all later rounds.
+        // Clear every slice: a round may use fewer slices than the last one
+        for (std::pmr::vector<uint32_t>& kept : survivors) {
+            kept.clear();
+        }
+        parallelFor(numThreads, alive.size(), [&](size_t slice, size_t begin, size_t end) {
+            std::pmr::vector<uint32_t>& kept = survivors[slice];
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t e = alive[i];
+                int cv = component[edges.src[e]];
+                int cw = component[edges.dst[e]];
+                if (cv == cw) continue;
+
+                uint64_t key = weightKey(edges.weight[e], e);
+                atomicMin(best[cv], key);
+                atomicMin(best[cw], key);
+                kept.push_back(alive[i]);
+            }
+        });
+
+        // Contract along the selected edges. With a strict total order on the
+        // keys the selected edges cannot form a cycle; the DSU check only
+        // skips an edge chosen by both of its endpoint components.
+        size_t added = 0;
+        for (int c = 0; c < V; ++c) {
+            uint64_t key = best[c].load(std::memory_order_relaxed);
+            if (key == NO_EDGE) continue;
+
+            uint32_t e = keyIndex(key);
+            if (dsu.find(edges.src[e]) != dsu.find(edges.dst[e])) {
+                dsu.unite(edges.src[e], edges.dst[e]);
+                mstKeys.push_back(key);
+                added++;
+            }
+        }
+        if (added == 0) break;
+
+        alive.clear();
+        for (const std::pmr::vector<uint32_t>& kept : survivors) {
+            alive.insert(alive.end(), kept.begin(), kept.end());
+        }
+    }
+
+    // Same contract as Kruskal: an incomplete tree means a disconnected graph
+    if (mstKeys.size() != static_cast<size_t>(V - 1)) {
+        return {};
+    }
+
+    // Report edges in Kruskal's order (by weight, then insertion order)
+    std::sort(mstKeys.begin(), mstKeys.end());
+    std::vector<Edge> mstEdges;
+    mstEdges.reserve(mstKeys.size());
+    for (uint64_t key : mstKeys) {
+        mstEdges.push_back(edges[keyIndex(key)]);
+    }
+
+    return mstEdges;
+}
@@ -0,0 +1,23 @@
+#ifndef BORUVKA_MST_SOLVER_HPP
+#define BORUVKA_MST_SOLVER_HPP
+
+#include "kruskal_mst_solver.hpp"
+#include <vector>
+
+// Parallel Boruvka: every round each worker scans a slice of the remaining
+// edges and records the lightest outgoing edge of each component, then the
+// components are contracted along those edges. Ties are broken by edge
+// insertion order, so the result is deterministic and equals Kruskal's
+// whenever edge weights are distinct. Shares KruskalMSTSolver's output format.
+class BoruvkaMSTSolver : public KruskalMSTSolver {
+public:
+    // numThreads == 0 uses one slice per worker of Scheduler::instance()
+    explicit BoruvkaMSTSolver(unsigned numThreads = 0);
+
+    std::vector<Edge> solveMST(Graph& graph) override;
+
+private:
+    unsigned numThreads;
+};
+
+#endif // BORUVKA_MST_SOLVER_HPP
@@ -0,0 +1,96 @@
+#include "connection.hpp"
+#include "logger.hpp"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+
+Connection::Connection(int fd) : fd_(fd), inPos(0), closed(false) {}
+
+Connection::~Connection() {
+    close(fd_);
+}
+
+void Connection::send(const std::string& data) {
+    send(data.data(), data.size());
+}
+
+void Connection::send(const char* data, size_t length) {
+    if (isClosed()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        outBuf.append(data, length);
+    }
+    outputQueued();
+}
+
+void Connection::flushPending() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    writeLocked();
+}
+
+bool Connection::hasPendingOutput() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return !outBuf.empty() && !isClosed();
+}
+
+size_t Connection::pendingOutput() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return isClosed() ? 0 : outBuf.size();
+}
+
+bool Connection::takeOutput(std::string& buffer) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (outBuf.empty() || isClosed()) return false;
+    buffer.swap(outBuf);
+    outBuf.clear();
+    return true;
+}
+
+void Connection::writeLocked() {
+    size_t written = 0;
+    while (written < outBuf.size() && !isClosed()) {
+        // MSG_NOSIGNAL: a vanished client must not SIGPIPE the whole server
+        ssize_t n = ::send(fd_, outBuf.data() + written, outBuf.size() - written, MSG_NOSIGNAL);
+        if (n > 0) {
+            written += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break; // The event loop calls flushPending() once the socket drains
+        } else {
+            LOG_ERROR("Failed to write to client (FD: " << fd_ << "): " << std::strerror(errno));
+            markClosed();
+            outBuf.clear();
+            return;
+        }
+    }
+    outBuf.erase(0, written);
+}
+
+void Connection::consume(size_t length) {
+    inPos += length;
+    if (inPos == inBuf.size()) {
+        inBuf.clear();
+        inPos = 0;
+    }
+}
+
+bool Connection::nextLine(std::string& line) {
+    size_t end = inBuf.find('\n', inPos);
+    if (end == std::string::npos) {
+        // Drop consumed bytes so the buffer only holds the partial line
+        if (inPos > 0) {
+            inBuf.erase(0, inPos);
+            inPos = 0;
+        }
+        return false;
+    }
+
+    size_t length = end - inPos;
+    if (length > 0 && inBuf[end - 1] == '\r') length--;
+    line.assign(inBuf, inPos, length);
+    inPos = end + 1;
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef CONNECTION_HPP
+#define CONNECTION_HPP
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// One client socket driven by an event loop. The read side (inBuf) is only
+// touched by the thread handling the socket's events; send() may be called
+// from any thread and buffers whatever the non-blocking socket cannot take
+// right away.
+// I/O backends that complete writes on their own loop derive from this and
+// override outputQueued().
+class Connection : public std::enable_shared_from_this<Connection> {
+public:
+    explicit Connection(int fd);
+    virtual ~Connection(); // Closes the socket once the last owner lets go
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    int fd() const { return fd_; }
+
+    // Queue bytes for the client, writing as much as possible immediately
+    void send(const std::string& data);
+    void send(const char* data, size_t length);
+
+    // Write out buffered bytes; called by the event loop when writable
+    void flushPending();
+
+    // True while bytes from send() are waiting for the socket to drain
+    bool hasPendingOutput();
+
+    // How many bytes from send() are waiting (0 once closed)
+    size_t pendingOutput();
+
+    // Move everything queued by send() into buffer; false if nothing is queued
+    bool takeOutput(std::string& buffer);
+
+    // Stop sending: the peer is gone or the connection was dropped
+    void markClosed() { closed.store(true, std::memory_order_release); }
+    bool isClosed() const { return closed.load(std::memory_order_acquire); }
+
+    // Bytes received but not yet consumed by the protocol handler
+    std::string inBuf;
+
+    // Pop the next complete '\n'-terminated line (without "\r\n") off inBuf
+    bool nextLine(std::string& line);
+
+    // Unconsumed bytes of inBuf, for framed (binary) protocols
+    const char* pendingData() const { return inBuf.data() + inPos; }
+    size_t pendingSize() const { return inBuf.size() - inPos; }
+    void consume(size_t length);
+
+protected:
+    // Called by send() after bytes were queued. The default writes directly
+    // on the calling thread; completion-based backends hand off to their loop.
+    virtual void outputQueued() { flushPending(); }
+
+private:
+    // Write from outBuf until it is empty or the socket would block.
+    // Caller holds writeMutex.
+    void writeLocked();
+
+    int fd_;
+    size_t inPos; // Start of unconsumed bytes in inBuf
+    std::mutex writeMutex;
+    std::string outBuf;
+    std::atomic<bool> closed;
+};
+
+// Callbacks from an I/O backend to the protocol/session layer. All of them
+// run on the backend's event-loop thread.
+class ConnectionHandler {
+public:
+    virtual ~ConnectionHandler() = default;
+    virtual void onConnect(const std::shared_ptr<Connection>& conn) = 0;
+    // New bytes were appended to conn->inBuf. Returning false pauses reading
+    // conn: the backend calls onData again, without new bytes, after output
+    // to conn makes progress or IOBackend::recheckConnections() is called,
+    // and reads on once it returns true.
+    virtual bool onData(const std::shared_ptr<Connection>& conn) = 0;
+    // The client sent EOF. It may only have half-closed, so the backend keeps
+    // conn open for output until hasPendingWork() is false and the output has
+    // drained, asking again on write progress and recheckConnections().
+    virtual void onInputClosed(const std::shared_ptr<Connection>& conn) = 0;
+    virtual bool hasPendingWork(const std::shared_ptr<Connection>& conn) = 0;
+    // The backend is done with conn: after the above, or at once on errors
+    virtual void onDisconnect(const std::shared_ptr<Connection>& conn) = 0;
+};
+
+#endif // CONNECTION_HPP
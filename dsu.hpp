@@ -0,0 +1,33 @@
+#ifndef DSU_HPP
+#define DSU_HPP
+
+#include <memory_resource>
+#include <vector>
+
+// Disjoint Set Union (union-find) used by the edge-based MST solvers
+class DSU {
+    std::pmr::vector<int> parent, rank;
+
+public:
+    explicit DSU(int n, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : parent(n, -1, resource), rank(n, 1, resource) {}
+
+    // Find with path compression
+    int find(int i) {
+        if (parent[i] == -1) return i;
+        return parent[i] = find(parent[i]);
+    }
+
+    // Union by rank
+    void unite(int x, int y) {
+        int s1 = find(x);
+        int s2 = find(y);
+        if (s1 != s2) {
+            if (rank[s1] < rank[s2]) parent[s1] = s2;
+            else if (rank[s1] > rank[s2]) parent[s2] = s1;
+            else { parent[s2] = s1; rank[s1]++; }
+        }
+    }
+};
+
+#endif // DSU_HPP
@@ -0,0 +1,85 @@
+#include "edge_sort.hpp"
+#include "weight_kernels.hpp"
+#include <algorithm>
+
+namespace {
+
+// Below this many edges a comparison sort is faster than bucketing
+const size_t MIN_RADIX_SIZE = 1 << 12;
+
+// Counting sort is used while the bucket array stays this small, or below
+// an eighth of the input size; past that its random scatter over a large
+// count array loses to two radix passes
+const uint64_t SMALL_RANGE = 1 << 16;
+
+const int RADIX_BITS = 16;
+const uint32_t RADIX_MASK = (1u << RADIX_BITS) - 1;
+const size_t RADIX_BUCKETS = size_t(1) << RADIX_BITS;
+
+// Turn per-bucket counts (shifted by one) into start positions
+void prefixSum(std::pmr::vector<size_t>& start) {
+    for (size_t b = 1; b < start.size(); ++b) {
+        start[b] += start[b - 1];
+    }
+}
+
+} // namespace
+
+std::pmr::vector<uint64_t> sortedWeightKeys(const std::pmr::vector<int>& weights, std::pmr::memory_resource* resource) {
+    size_t n = weights.size();
+    std::pmr::vector<uint64_t> keys(n, 0, resource);
+    if (n < MIN_RADIX_SIZE) {
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = weightKey(weights[i], static_cast<uint32_t>(i));
+        }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    int minWeight, maxWeight;
+    minMaxWeight(weights.data(), n, minWeight, maxWeight);
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(maxWeight) - minWeight);
+
+    // Offsets from the minimum weight fit in 32 bits for any pair of ints
+    auto offset = [minWeight](int weight) {
+        return static_cast<uint32_t>(static_cast<int64_t>(weight) - minWeight);
+    };
+
+    if (range < std::max<uint64_t>(SMALL_RANGE, n / 8)) {
+        // Counting sort: scan the weights, scatter the keys in index order
+        std::pmr::vector<size_t> start(range + 2, 0, resource);
+        for (size_t i = 0; i < n; ++i) {
+            start[offset(weights[i]) + 1]++;
+        }
+        prefixSum(start);
+        for (size_t i = 0; i < n; ++i) {
+            keys[start[offset(weights[i])]++] = weightKey(weights[i], static_cast<uint32_t>(i));
+        }
+        return keys;
+    }
+
+    // Two stable LSD passes over 64-bit (offset, index) keys: low digit
+    // straight from the weights into scratch, high digit back into keys.
+    // Both histograms come from one pass over the weights.
+    std::pmr::vector<size_t> low(RADIX_BUCKETS + 1, 0, resource);
+    std::pmr::vector<size_t> high(RADIX_BUCKETS + 1, 0, resource);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t off = offset(weights[i]);
+        low[(off & RADIX_MASK) + 1]++;
+        high[(off >> RADIX_BITS) + 1]++;
+    }
+    prefixSum(low);
+    prefixSum(high);
+
+    std::pmr::vector<uint64_t> scratch(n, 0, resource);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t off = offset(weights[i]);
+        scratch[low[off & RADIX_MASK]++] = (static_cast<uint64_t>(off) << 32) | i;
+    }
+    for (uint64_t entry : scratch) {
+        uint32_t off = static_cast<uint32_t>(entry >> 32);
+        int weight = static_cast<int>(static_cast<int64_t>(off) + minWeight);
+        keys[high[off >> RADIX_BITS]++] = weightKey(weight, keyIndex(entry));
+    }
+    return keys;
+}
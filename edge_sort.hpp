@@ -0,0 +1,35 @@
+#ifndef EDGE_SORT_HPP
+#define EDGE_SORT_HPP
+
+#include "graph.hpp"
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// Sort key of edge index with weight: the weight (biased to unsigned order)
+// in the high 32 bits, the index in the low 32. Sorting keys orders edges by
+// weight, then by index, and an 8-byte key is all the sort has to move.
+inline uint64_t weightKey(int weight, uint32_t index) {
+    uint32_t biased = static_cast<uint32_t>(weight) ^ 0x80000000u; // Signed -> unsigned order
+    return (static_cast<uint64_t>(biased) << 32) | index;
+}
+
+inline uint32_t keyIndex(uint64_t key) {
+    return static_cast<uint32_t>(key);
+}
+
+inline int keyWeight(uint64_t key) {
+    return static_cast<int>(static_cast<uint32_t>(key >> 32) ^ 0x80000000u);
+}
+
+// Keys of all edges of weights (EdgeArrays::weight) in ascending order,
+// allocated from resource like any buffers the sort needs. Picks the
+// cheapest strategy for the input:
+//  - counting sort when the weight range is small (one scatter pass),
+//  - LSD radix sort on 16-bit digits for large inputs with a wide range,
+//  - std::sort for small inputs, where the bucket setup does not pay off.
+// Both bucket sorts read only the weight array, never the endpoints.
+std::pmr::vector<uint64_t> sortedWeightKeys(const std::pmr::vector<int>& weights,
+                                            std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+#endif // EDGE_SORT_HPP
@@ -0,0 +1,103 @@
+// filter_kruskal_mst_solver.cpp
+
+#include "filter_kruskal_mst_solver.hpp"
+#include "dsu.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+
+namespace {
+
+// Ranges at or below this size are sorted and scanned like plain Kruskal
+const size_t BASE_CASE_SIZE = 1024;
+
+struct FilterKruskal {
+    DSU dsu;
+    std::vector<Edge> mstEdges;
+    size_t target; // V - 1
+    uint64_t rngState = 0x9E3779B97F4A7C15ull; // Fixed seed keeps runs reproducible
+
+    FilterKruskal(int V, std::pmr::memory_resource* resource) : dsu(V, resource), target(V - 1) {
+        mstEdges.reserve(target);
+    }
+
+    bool done() const { return mstEdges.size() == target; }
+
+    size_t randomIndex(size_t n) {
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 7;
+        rngState ^= rngState << 17;
+        return rngState % n;
+    }
+
+    // Kruskal step over a range already in weight order
+    void scan(EdgeList::iterator begin, EdgeList::iterator end) {
+        for (auto it = begin; it != end && !done(); ++it) {
+            if (dsu.find(it->v) != dsu.find(it->w)) {
+                dsu.unite(it->v, it->w);
+                mstEdges.push_back(*it);
+            }
+        }
+    }
+
+    void solve(EdgeList::iterator begin, EdgeList::iterator end) {
+        // The heavy half is handled by looping rather than recursing
+        while (!done() && begin != end) {
+            size_t n = static_cast<size_t>(end - begin);
+            if (n <= BASE_CASE_SIZE) {
+                std::sort(begin, end);
+                scan(begin, end);
+                return;
+            }
+
+            // Median of three random samples as the pivot weight
+            int a = begin[randomIndex(n)].weight;
+            int b = begin[randomIndex(n)].weight;
+            int c = begin[randomIndex(n)].weight;
+            int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+            // Three-way split: [< pivot][== pivot][> pivot]
+            auto equalBegin = std::partition(begin, end, [pivot](const Edge& e) { return e.weight < pivot; });
+            auto heavyBegin = std::partition(equalBegin, end, [pivot](const Edge& e) { return e.weight == pivot; });
+
+            solve(begin, equalBegin);
+            scan(equalBegin, heavyBegin); // All the same weight, no sort needed
+            if (done()) return;
+
+            // Filter: drop heavy edges that would only close a cycle
+            begin = heavyBegin;
+            end = std::partition(begin, end, [this](const Edge& e) {
+                return dsu.find(e.v) != dsu.find(e.w);
+            });
+        }
+    }
+};
+
+} // namespace
+
+std::vector<Edge> FilterKruskalMSTSolver::solveMST(Graph& graph) {
+    int V = graph.getV();
+    if (V == 0 || graph.getEdges().empty()) {
+        return {};
+    }
+
+    // Scratch comes from one buffer in the graph's arena, freed in one go
+    std::pmr::monotonic_buffer_resource scratch(graph.getEdges().size() * sizeof(Edge) + 2 * V * sizeof(int) + 256,
+                                                graph.resource());
+    // Partitioning moves whole edges, so this solver works on structs
+    const EdgeArrays& graphEdges = graph.getEdges();
+    EdgeList edges(&scratch); // Partitioned in place
+    edges.reserve(graphEdges.size());
+    for (size_t i = 0; i < graphEdges.size(); ++i) {
+        edges.push_back(graphEdges[i]);
+    }
+    FilterKruskal fk(V, &scratch);
+    fk.solve(edges.begin(), edges.end());
+
+    // Same contract as Kruskal: an incomplete tree means a disconnected graph
+    if (!fk.done()) {
+        return {};
+    }
+
+    return std::move(fk.mstEdges);
+}
@@ -0,0 +1,16 @@
+#ifndef FILTER_KRUSKAL_MST_SOLVER_HPP
+#define FILTER_KRUSKAL_MST_SOLVER_HPP
+
+#include "kruskal_mst_solver.hpp"
+#include <vector>
+
+// Filter-Kruskal: quicksort-style partitioning on a pivot weight, solving the
+// light half first and discarding heavy edges whose endpoints are already
+// connected before recursing into them. On dense graphs most edges are
+// filtered out without ever being sorted. Shares KruskalMSTSolver's output format.
+class FilterKruskalMSTSolver : public KruskalMSTSolver {
+public:
+    std::vector<Edge> solveMST(Graph& graph) override;
+};
+
+#endif // FILTER_KRUSKAL_MST_SOLVER_HPP
@@ -0,0 +1,26 @@
+#ifndef FUTEX_HPP
+#define FUTEX_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Thin wrappers over the Linux futex syscall on a 32-bit atomic word,
+// shared by the scheduler and the ActiveObject queues for parking threads.
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit int");
+
+// Sleep while word == expected (returns at once if it already differs;
+// spurious wake-ups are possible, so callers re-check their condition)
+inline void futexWait(std::atomic<uint32_t>& word, uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+// Wake up to count threads sleeping on word
+inline void futexWake(std::atomic<uint32_t>& word, int count) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+#endif // FUTEX_HPP
@@ -1,59 +1,299 @@
 #include "graph.hpp"
+#include "incremental_mst.hpp"
+#include "logger.hpp"
+#include "weight_kernels.hpp"
 #include <algorithm>
-#include <numeric>
+#include <atomic>
 #include <climits>
 #include <queue>
+#include <sstream>
+#include <stdexcept>
 #include <vector>
 #include <limits.h>
 
-Graph::Graph(int V) : V(V), adj(V) {}
+EdgeArrays::EdgeArrays(const std::vector<Edge>& edges, std::pmr::memory_resource* resource)
+    : src(resource), dst(resource), weight(resource) {
+    reserve(edges.size());
+    for (const Edge& edge : edges) {
+        push_back(edge);
+    }
+}
+
+CSRGraph CSRGraph::build(int V, const EdgeArrays& edges, std::pmr::memory_resource* resource) {
+    CSRGraph csr(resource);
+    csr.offsets.assign(V + 1, 0);
+    size_t E = edges.size();
+
+    // Count the degree of every vertex, shifted by one for the prefix sum
+    for (size_t e = 0; e < E; ++e) {
+        csr.offsets[edges.src[e] + 1]++;
+        csr.offsets[edges.dst[e] + 1]++;
+    }
+    for (int u = 0; u < V; ++u) {
+        csr.offsets[u + 1] += csr.offsets[u];
+    }
+
+    csr.neighbors.resize(csr.offsets[V]);
+    csr.weights.resize(csr.offsets[V]);
+
+    // Scatter both directions of every edge into its vertex's slice
+    std::pmr::vector<int> next(csr.offsets.begin(), csr.offsets.end() - 1, resource);
+    for (size_t e = 0; e < E; ++e) {
+        int v = edges.src[e];
+        int w = edges.dst[e];
+
+        int i = next[v]++;
+        csr.neighbors[i] = w;
+        csr.weights[i] = edges.weight[e];
+
+        int j = next[w]++;
+        csr.neighbors[j] = v;
+        csr.weights[j] = edges.weight[e];
+    }
+
+    return csr;
+}
+
+// Process-wide source of graph versions
+static uint64_t nextVersion() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+Graph::Graph(int V, std::shared_ptr<SessionArena> arena)
+    : arena(std::move(arena)), V(V), version(nextVersion()), edges(resource()), csr(resource()), csrValid(false),
+      mstPending(resource()), edgeIndex(resource()) {}
+
+// pmr containers copy onto the default resource unless told otherwise
+Graph::Graph(const Graph& other)
+    : arena(other.arena), V(other.V), version(other.version), edges(other.edges, resource()),
+      csr(other.csr, resource()), csrValid(other.csrValid), mstValid(other.mstValid),
+      mst(other.mst ? std::make_unique<IncrementalMST>(*other.mst) : nullptr), mstPending(other.mstPending, resource()),
+      mstBaseVersion(other.mstBaseVersion), edgeIndex(other.edgeIndex, resource()),
+      edgeIndexValid(other.edgeIndexValid) {}
+
+// The arena is shared rather than moved: other's emptied containers still
+// point at it and may be reused
+Graph::Graph(Graph&& other) noexcept
+    : arena(other.arena), V(other.V), version(other.version), edges(std::move(other.edges)),
+      csr(std::move(other.csr)), csrValid(other.csrValid), mstValid(other.mstValid), mst(std::move(other.mst)),
+      mstPending(std::move(other.mstPending)), mstBaseVersion(other.mstBaseVersion),
+      edgeIndex(std::move(other.edgeIndex)), edgeIndexValid(other.edgeIndexValid) {}
+
+Graph& Graph::operator=(const Graph& other) {
+    if (this != &other) {
+        *this = Graph(other);
+    }
+    return *this;
+}
+
+// Member-wise, except that the arena stays: the containers keep allocating
+// from this graph's resource (pmr allocators do not propagate on assignment),
+// taking other's buffers only when both graphs share a resource. Otherwise
+// the elements are copied, so this may throw
+Graph& Graph::operator=(Graph&& other) {
+    V = other.V;
+    version = other.version;
+    edges = std::move(other.edges);
+    csr = std::move(other.csr);
+    csrValid = other.csrValid;
+    mstValid = other.mstValid;
+    mst = std::move(other.mst);
+    mstPending = std::move(other.mstPending);
+    mstBaseVersion = other.mstBaseVersion;
+    edgeIndex = std::move(other.edgeIndex);
+    edgeIndexValid = other.edgeIndexValid;
+    return *this;
+}
+
+Graph::~Graph() = default;
 
 void Graph::addEdge(int v, int w, int weight) {
-    if (v >= V || w >= V) {
+    if (v < 0 || w < 0 || v >= V || w >= V) {
         throw std::out_of_range("Vertex out of range");
     }
-    adj[v].push_back(Edge(v, w, weight));
-    adj[w].push_back(Edge(w, v, weight));
     edges.push_back(Edge(v, w, weight));
+    version = nextVersion();
+    csrValid = false;
+    if (edgeIndexValid) {
+        edgeIndex.emplace(edgeKey(v, w), edges.size() - 1);
+    }
+    if (mstValid || mstBaseVersion != 0) {
+        mstPending.push_back(Edge(v, w, weight));
+        if (mstPending.size() > std::max<size_t>(256, edges.size() / 64)) {
+            dropMST();
+        }
+    }
+}
+
+void Graph::reserveEdges(size_t count) {
+    edges.reserve(edges.size() + count);
 }
 
-void Graph::removeEdge(int v, int w) {
-    if (v >= V || w >= V) {
+void Graph::buildEdgeIndex() {
+    edgeIndex.clear();
+    edgeIndex.reserve(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        edgeIndex.emplace(edgeKey(edges.src[i], edges.dst[i]), i);
+    }
+    edgeIndexValid = true;
+}
+
+size_t Graph::removeEdge(int v, int w) {
+    if (v < 0 || w < 0 || v >= V || w >= V) {
         throw std::out_of_range("Vertex out of range");
     }
+    if (!edgeIndexValid) {
+        buildEdgeIndex();
+    }
 
-    // Remove both v->w and w->v edges for undirected graph
-    edges.erase(std::remove_if(edges.begin(), edges.end(), [v, w](Edge const& edge) {
-        return (edge.v == v && edge.w == w) || (edge.v == w && edge.w == v);
-    }), edges.end());
+    // Both v->w and w->v share one key, covering the undirected edge
+    auto range = edgeIndex.equal_range(edgeKey(v, w));
+    std::pmr::vector<size_t> slots(resource());
+    for (auto it = range.first; it != range.second; ++it) {
+        slots.push_back(it->second);
+    }
+    if (slots.empty()) return 0;
+    edgeIndex.erase(range.first, range.second);
+
+    // Highest slot first, so the tail edge moved into a hole is never one
+    // that is still waiting to be removed
+    std::sort(slots.rbegin(), slots.rend());
+    for (size_t slot : slots) {
+        size_t last = edges.size() - 1;
+        if (slot != last) {
+            edges.set(slot, edges[last]);
+            auto moved = edgeIndex.equal_range(edgeKey(edges.src[slot], edges.dst[slot]));
+            for (auto it = moved.first; it != moved.second; ++it) {
+                if (it->second == last) {
+                    it->second = slot;
+                    break;
+                }
+            }
+        }
+        edges.pop_back();
+    }
+    version = nextVersion();
+    csrValid = false;
 
-    std::cout << "Edge removed between " << v << " and " << w << std::endl;
+    if (mstBaseVersion != 0) {
+        // The tree a clone is waiting for may contain the removed edge
+        mstPending.clear();
+        mstBaseVersion = 0;
+    }
+    if (mstValid) {
+        // Queued edges may be the ones removed; fold them in before checking
+        foldPendingMST();
+        if (mst->containsEdge(v, w)) {
+            dropMST();
+        }
+    }
+
+    LOG_DEBUG("Removed " << slots.size() << " edge(s) between " << v << " and " << w);
+    return slots.size();
+}
+
+void Graph::seedMST(const std::vector<Edge>& forestEdges) {
+    mst = std::make_unique<IncrementalMST>(V, forestEdges);
+    mstValid = true;
+    mstPending.clear();
+    mstBaseVersion = 0;
+}
+
+void Graph::dropMST() {
+    mst.reset();
+    mstValid = false;
+    mstPending.clear();
+    mstBaseVersion = 0;
+}
+
+Graph Graph::cloneEdgeSet() const {
+    Graph clone(V, arena);
+    clone.version = version;
+    clone.edges = edges;
+    clone.edgeIndex = edgeIndex;
+    clone.edgeIndexValid = edgeIndexValid;
+    clone.mstValid = false;
+    clone.mstBaseVersion = version;
+    return clone;
+}
+
+bool Graph::adoptMST(uint64_t baseVersion, const std::vector<Edge>& forestEdges) {
+    if (mstValid || mstBaseVersion == 0 || mstBaseVersion != baseVersion) return false;
+
+    // Keep the edges queued since the clone; they are folded in on the next solve
+    mst = std::make_unique<IncrementalMST>(V, forestEdges);
+    mstValid = true;
+    mstBaseVersion = 0;
+    return true;
+}
+
+bool Graph::hasMaintainedMST() const {
+    return mstValid;
+}
+
+void Graph::foldPendingMST() {
+    if (!mst) {
+        mst = std::make_unique<IncrementalMST>(V, std::vector<Edge>());
+    }
+    for (const Edge& edge : mstPending) {
+        mst->insert(edge);
+    }
+    mstPending.clear();
+}
+
+bool Graph::maintainedForest(std::vector<Edge>& forestEdges) {
+    if (!mstValid) return false;
+
+    foldPendingMST();
+    forestEdges = mst->edges();
+    return true;
+}
+
+bool Graph::maintainedMST(std::vector<Edge>& mstEdges) {
+    if (!mstValid) return false;
+
+    // Until the forest spans the graph the solvers decide what to report
+    foldPendingMST();
+    if (mst->size() != static_cast<size_t>(std::max(V - 1, 0))) return false;
+    mstEdges = mst->edges();
+    return true;
 }
 
 int Graph::getV() const {
     return V;
 }
 
-const std::vector<Edge>& Graph::getEdges() const {
+const EdgeArrays& Graph::getEdges() const {
     return edges;
 }
 
-const std::vector<std::vector<Edge>>& Graph::getAdj() const {
-    return adj;
+std::pmr::memory_resource* Graph::resource() const {
+    return arena ? arena.get() : std::pmr::get_default_resource();
+}
+
+const CSRGraph& Graph::getCSR() {
+    if (!csrValid) {
+        csr = CSRGraph::build(V, edges, resource());
+        csrValid = true;
+    }
+    return csr;
 }
 
 void Graph::printGraph() const {
+    CSRGraph adj = CSRGraph::build(V, edges);
+    std::ostringstream oss;
     for (int v = 0; v < V; ++v) {
-        std::cout << v << ": ";
-        for (const Edge& edge : adj[v]) {
-            std::cout << edge.w << " (" << edge.weight << ") ";
+        oss << "\n" << v << ": ";
+        for (int i = adj.offsets[v]; i < adj.offsets[v + 1]; ++i) {
+            oss << adj.neighbors[i] << " (" << adj.weights[i] << ") ";
         }
-        std::cout << std::endl;
     }
+    LOG_INFO("Graph with " << V << " vertices:" << oss.str());
 }
 
 // Helper function for Prim's algorithm to find the vertex with the minimum key
-int Graph::minKey(const std::vector<int>& key, const std::vector<bool>& inMST) const {
+int Graph::minKey(const std::pmr::vector<int>& key, const std::pmr::vector<bool>& inMST) const {
     int min = INT_MAX, min_index = -1;
 
     for (int v = 0; v < V; ++v) {
@@ -66,100 +306,96 @@ int Graph::minKey(const std::vector<int>& key, const std::vector<bool>& inMST) c
 }
 
 // Calculate total weight of MST
-int Graph::calculateTotalWeight(const std::vector<Edge>& mstEdges) const {
-    return std::accumulate(mstEdges.begin(), mstEdges.end(), 0, 
-        [](int sum, const Edge& edge) {
-            return sum + edge.weight;
-        }
-    );
+long long Graph::calculateTotalWeight(const EdgeArrays& mstEdges) const {
+    return sumWeights(mstEdges.weight.data(), mstEdges.size());
 }
 
 // Find the longest edge in the MST
-int Graph::findLongestDistance(const std::vector<Edge>& mstEdges) const {
-    // Create adjacency list for the MST
-    std::vector<std::vector<Edge>> mstAdj(V);
+int Graph::findLongestDistance(const EdgeArrays& mstEdges) const {
+    if (V == 0) return 0;
 
-    
-    for (const Edge& edge : mstEdges) {
-        mstAdj[edge.v].push_back(edge);
-        mstAdj[edge.w].push_back(Edge(edge.w, edge.v, edge.weight)); // Add reverse direction
-        
-    }
+    // Create CSR adjacency for the MST (both directions)
+    CSRGraph mstCSR = CSRGraph::build(V, mstEdges);
 
     // Step 1: Run BFS from any vertex (let's start from vertex 0)
-    auto [farthestVertex, _firstDistance] = bfs(0, mstAdj);
+    auto [farthestVertex, _firstDistance] = bfs(0, mstCSR);
 
     // Step 2: Run BFS from the farthest vertex found to get the longest path
-    auto [_secondVertex, maxDist] = bfs(farthestVertex, mstAdj);
+    auto [_secondVertex, maxDist] = bfs(farthestVertex, mstCSR);
 
     return maxDist; // This is the longest distance in the MST (diameter)
 }
 
 
 
-double Graph::calculateAverageDistance(const std::vector<Edge>& mstEdges) const {
-    // Create adjacency list for the MST
-    std::vector<std::vector<Edge>> mstAdj(V);
-
-    for (const Edge& edge : mstEdges) {
-        mstAdj[edge.v].push_back(edge); // Forward edge
-        mstAdj[edge.w].push_back(Edge(edge.w, edge.v, edge.weight)); // Reverse direction
-    }
-
-    // Initialize distance matrix for the MST
-    std::vector<std::vector<int>> dist(V, std::vector<int>(V, INT_MAX));
-    for (int i = 0; i < V; i++) {
-        dist[i][i] = 0; // Distance to self is 0
-    }
-
-    // Fill distances based on MST edges
-    for (const Edge& edge : mstEdges) {
-        dist[edge.v][edge.w] = edge.weight;
-        dist[edge.w][edge.v] = edge.weight; // Undirected
-    }
-
-    // Floyd-Warshall algorithm to compute shortest paths between all pairs
-    for (int k = 0; k < V; ++k) {
-        for (int i = 0; i < V; ++i) {
-            for (int j = 0; j < V; ++j) {
-                if (dist[i][k] != INT_MAX && dist[k][j] != INT_MAX) {
-                    dist[i][j] = std::min(dist[i][j], dist[i][k] + dist[k][j]);
+// Average distance over all connected vertex pairs of the MST.
+// In a tree every pair is joined by exactly one path, so an edge that splits
+// its component into size and (n - size) vertices lies on size * (n - size)
+// of those paths. Summing weight * size * (n - size) over the edges gives the
+// total pairwise distance in O(V) time and memory.
+double Graph::calculateAverageDistance(const EdgeArrays& mstEdges) const {
+    CSRGraph mstCSR = CSRGraph::build(V, mstEdges);
+
+    std::vector<int> parent(V, -1);
+    std::vector<int> parentWeight(V, 0);
+    std::vector<long long> subtreeSize(V, 1);
+    std::vector<bool> visited(V, false);
+    std::vector<int> order; // DFS preorder, parents before children
+    std::vector<int> stack;
+    order.reserve(V);
+
+    long long totalDistance = 0;
+    long long totalPairs = 0;
+
+    for (int root = 0; root < V; ++root) {
+        if (visited[root]) continue;
+
+        // Iterative DFS over this component
+        size_t first = order.size();
+        visited[root] = true;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            order.push_back(u);
+            for (int i = mstCSR.offsets[u]; i < mstCSR.offsets[u + 1]; ++i) {
+                int v = mstCSR.neighbors[i];
+                if (!visited[v]) {
+                    visited[v] = true;
+                    parent[v] = u;
+                    parentWeight[v] = mstCSR.weights[i];
+                    stack.push_back(v);
                 }
             }
         }
-    }
 
-    // Sum all distances for unique pairs (i < j)
-    int totalDistance = 0;
-    int totalPairs = 0;
+        // Accumulate subtree sizes bottom-up (reverse preorder)
+        for (size_t i = order.size() - 1; i > first; --i) {
+            subtreeSize[parent[order[i]]] += subtreeSize[order[i]];
+        }
 
-    for (int i = 0; i < V; ++i) {
-        for (int j = i + 1; j < V; ++j) {
-            if (dist[i][j] != INT_MAX) { // Ignore pairs not connected
-                totalDistance += dist[i][j];
-                totalPairs++;
-            }
+        // Each non-root vertex contributes the edge to its parent
+        long long n = static_cast<long long>(order.size() - first);
+        for (size_t i = first + 1; i < order.size(); ++i) {
+            int u = order[i];
+            totalDistance += parentWeight[u] * subtreeSize[u] * (n - subtreeSize[u]);
         }
+        totalPairs += n * (n - 1) / 2; // Only pairs connected through the MST
     }
 
     // Calculate and return the average distance
     return totalPairs > 0 ? static_cast<double>(totalDistance) / totalPairs : 0.0;
 }
 
-
-
-
 // Find the shortest edge in the MST
-int Graph::findShortestDistance(const std::vector<Edge>& mstEdges) const {
-    auto minEdge = std::min_element(mstEdges.begin(), mstEdges.end(),
-        [](const Edge& a, const Edge& b) {
-            return a.weight < b.weight;
-        }
-    );
-    return minEdge != mstEdges.end() ? minEdge->weight : 0;
+int Graph::findShortestDistance(const EdgeArrays& mstEdges) const {
+    if (mstEdges.empty()) return 0;
+    int shortest, longest;
+    minMaxWeight(mstEdges.weight.data(), mstEdges.size(), shortest, longest);
+    return shortest;
 }
 
-std::pair<int, int> Graph::bfs(int startVertex, const std::vector<std::vector<Edge>>& mstAdj) const {
+std::pair<int, int> Graph::bfs(int startVertex, const CSRGraph& mstCSR) const {
     std::vector<int> dist(V, INT_MAX); // Distance from the start vertex
     dist[startVertex] = 0;
 
@@ -174,10 +410,10 @@ std::pair<int, int> Graph::bfs(int startVertex, const std::vector<std::vector<Ed
         q.pop();
 
 
-        for (const Edge& edge : mstAdj[u]) {
-            int v = edge.w;
+        for (int i = mstCSR.offsets[u]; i < mstCSR.offsets[u + 1]; ++i) {
+            int v = mstCSR.neighbors[i];
             if (dist[v] == INT_MAX) { // If not visited
-                dist[v] = dist[u] + edge.weight; // Update distance
+                dist[v] = dist[u] + mstCSR.weights[i]; // Update distance
                 q.push(v);
 
 
@@ -1,9 +1,14 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
+#include "arena.hpp"
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <unordered_map>
 
 class Edge {
 public:
@@ -17,36 +22,175 @@ public:
     }
 };
 
+// Edges as structs, allocated from a graph's memory resource
+using EdgeList = std::pmr::vector<Edge>;
+
+// Structure-of-arrays edge list: edge i is src[i] - dst[i] with weight[i].
+// Kernels that need only the weights (sorting, sums, minima) or only the
+// endpoints stream just those arrays instead of whole Edge structs.
+class EdgeArrays {
+public:
+    std::pmr::vector<int> src;
+    std::pmr::vector<int> dst;
+    std::pmr::vector<int> weight;
+
+    explicit EdgeArrays(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : src(resource), dst(resource), weight(resource) {}
+    EdgeArrays(const EdgeArrays& other, std::pmr::memory_resource* resource)
+        : src(other.src, resource), dst(other.dst, resource), weight(other.weight, resource) {}
+    explicit EdgeArrays(const std::vector<Edge>& edges,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    size_t size() const { return weight.size(); }
+    bool empty() const { return weight.empty(); }
+    Edge operator[](size_t i) const { return Edge(src[i], dst[i], weight[i]); }
+
+    void push_back(const Edge& edge) {
+        src.push_back(edge.v);
+        dst.push_back(edge.w);
+        weight.push_back(edge.weight);
+    }
+    void pop_back() {
+        src.pop_back();
+        dst.pop_back();
+        weight.pop_back();
+    }
+    void set(size_t i, const Edge& edge) {
+        src[i] = edge.v;
+        dst[i] = edge.w;
+        weight[i] = edge.weight;
+    }
+    void reserve(size_t count) {
+        src.reserve(count);
+        dst.reserve(count);
+        weight.reserve(count);
+    }
+};
+
+// Order-independent key of the vertex pair {v, w}
+inline uint64_t edgeKey(int v, int w) {
+    if (v > w) std::swap(v, w);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(v)) << 32) | static_cast<uint32_t>(w);
+}
+
+// Frozen compressed sparse row (CSR) view of an undirected graph.
+// The neighbours of vertex u are neighbors[offsets[u] .. offsets[u + 1])
+// with the matching edge weights at the same positions in weights.
+class CSRGraph {
+public:
+    std::pmr::vector<int> offsets;   // V + 1 entries
+    std::pmr::vector<int> neighbors; // 2 * E entries (both directions)
+    std::pmr::vector<int> weights;   // 2 * E entries, parallel to neighbors
+
+    explicit CSRGraph(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : offsets(resource), neighbors(resource), weights(resource) {}
+    CSRGraph(const CSRGraph& other, std::pmr::memory_resource* resource)
+        : offsets(other.offsets, resource), neighbors(other.neighbors, resource), weights(other.weights, resource) {}
+
+    // Build the CSR arrays from an edge list in a single counting pass.
+    // Neighbours keep the insertion order of the edge list.
+    static CSRGraph build(int V, const EdgeArrays& edges,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    int degree(int u) const { return offsets[u + 1] - offsets[u]; }
+};
+
+class IncrementalMST;
+
+// All of a graph's storage (edge list, CSR, edge index) comes from its
+// session arena when it has one, and copies of the graph share that arena.
+// Assigning to a graph keeps its own arena and copies the contents into it.
 class Graph {
 public:
-    Graph(int V);
+    explicit Graph(int V, std::shared_ptr<SessionArena> arena = nullptr);
+    Graph(const Graph& other);
+    Graph(Graph&& other) noexcept;
+    Graph& operator=(const Graph& other);
+    Graph& operator=(Graph&& other);
+    ~Graph();
 
     void addEdge(int v, int w, int weight);
-    void removeEdge(int v, int w);
+
+    // Remove every edge between v and w; returns how many were removed.
+    // Amortised O(1) per edge via the pair index and swap-and-pop, so the
+    // edge list order is not preserved.
+    size_t removeEdge(int v, int w);
+
+    // Pre-size the edge list for count more edges (bulk loading)
+    void reserveEdges(size_t count);
 
     int getV() const;
-    const std::vector<Edge>& getEdges() const;
-    const std::vector<std::vector<Edge>>& getAdj() const;
+    const EdgeArrays& getEdges() const;
+
+    // Where the graph allocates: its arena, or the default heap resource.
+    // Solvers take their scratch memory from here as well.
+    std::pmr::memory_resource* resource() const;
+
+    // Changes whenever the edge set does. Versions are unique across all
+    // graphs in the process, so equal versions mean equal contents.
+    uint64_t getVersion() const { return version; }
+
+    // Frozen CSR adjacency, rebuilt from the edge list after any mutation
+    const CSRGraph& getCSR();
+
+    // Minimum spanning forest maintained across addEdge, from the graph's
+    // creation or from seedMST. Added edges are queued and folded into the
+    // forest on the next maintainedMST/maintainedForest call, each linking two
+    // components or replacing a heavier cycle edge. The forest is dropped when
+    // one of its edges is removed, or when so many edges queue up that solving
+    // from scratch is cheaper than the O(log V) link-cut update per edge;
+    // seedMST then restarts it from a minimum spanning forest.
+    void seedMST(const std::vector<Edge>& forestEdges);
+    bool hasMaintainedMST() const;
+    // The forest, ordered by weight; false when it is not maintained
+    bool maintainedForest(std::vector<Edge>& forestEdges);
+    // As maintainedForest, but only once the forest spans the graph
+    bool maintainedMST(std::vector<Edge>& mstEdges);
+
+    // Copy of the edge set and version only, leaving out the lazily derived
+    // state (CSR, incremental MST) that a concurrent solve may be building.
+    // The copy queues its added edges so that adoptMST can seed it later.
+    Graph cloneEdgeSet() const;
+
+    // Seed the incremental MST of a clone with the forest of the graph
+    // it was cloned from; false if the clone has diverged (edges removed).
+    bool adoptMST(uint64_t baseVersion, const std::vector<Edge>& forestEdges);
 
     // Method to print the graph
     void printGraph() const;
 
-    int minKey(const std::vector<int>& key, const std::vector<bool>& inMST) const;
+    int minKey(const std::pmr::vector<int>& key, const std::pmr::vector<bool>& inMST) const;
 
     // Calculate total, longest, and shortest distances in MST
-    int calculateTotalWeight(const std::vector<Edge>& mstEdges) const;
-    int findLongestDistance(const std::vector<Edge>& mstEdges) const;
-    int findShortestDistance(const std::vector<Edge>& mstEdges) const;
-    double calculateAverageDistance(const std::vector<Edge>& mstEdges) const;
+    long long calculateTotalWeight(const EdgeArrays& mstEdges) const;
+    int findLongestDistance(const EdgeArrays& mstEdges) const;
+    int findShortestDistance(const EdgeArrays& mstEdges) const;
+    double calculateAverageDistance(const EdgeArrays& mstEdges) const;
     
     // Helper method for BFS to find the farthest vertex and distance
-    std::pair<int, int> bfs(int startVertex, const std::vector<std::vector<Edge>>& mstAdj) const;
+    std::pair<int, int> bfs(int startVertex, const CSRGraph& mstCSR) const;
 
 
 private:
+    std::shared_ptr<SessionArena> arena; // Null: default resource. First, so it outlives the containers
     int V; // Number of vertices
-    std::vector<std::vector<Edge>> adj; // Adjacency list
-    std::vector<Edge> edges; // Edge list
+    uint64_t version; // See getVersion
+    EdgeArrays edges; // Edge list (single source of truth)
+    CSRGraph csr; // Adjacency built from edges on demand
+    bool csrValid; // False once edges changed since the last build
+    bool mstValid = true; // mst (created on first fold) plus mstPending is the minimum spanning forest
+    std::unique_ptr<IncrementalMST> mst;
+    EdgeList mstPending; // Edges added since mst was last updated
+    uint64_t mstBaseVersion = 0; // Non-zero: clone queuing edges for adoptMST
+
+    // Vertex pair -> positions in edges, built by the first removeEdge so
+    // bulk loads that never remove do not pay for it
+    std::pmr::unordered_multimap<uint64_t, size_t> edgeIndex;
+    bool edgeIndexValid = false;
+
+    void buildEdgeIndex();
+    void foldPendingMST();
+    void dropMST();
 };
 
 #endif // GRAPH_HPP
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "pipelineStage.hpp"
 #include "pipelineData.hpp"
+#include "logger.hpp"
 
 class graphParsingStage : public pipelineStage {
 public:
@@ -10,9 +11,9 @@ public:
         // Only handle "create" command
         if (data->command == "create") {
             // Initialize the graph
-            data->graph = Graph(data->vertices);
+            data->graph = std::make_shared<SharedGraph>(Graph(data->vertices));
             data->response = "Graph created with " + std::to_string(data->vertices) + " vertices and " + std::to_string(data->edges) + " edges.";
-            std::cout << "Debug: Graph created with " << data->vertices << " vertices and " << data->edges << " edges." << std::endl;
+            LOG_DEBUG("Graph created with " << data->vertices << " vertices and " << data->edges << " edges.");
 
             // Pass to the next stage
             if (nextStage) {
@@ -4,15 +4,18 @@
 #include "pipelineStage.hpp"
 #include "pipelineData.hpp"
 #include "task.hpp"
+#include "logger.hpp"
 
 class graphUpdateStage : public pipelineStage {
 public:
     void process(std::shared_ptr<pipelineData> data) override {
         if (data->command == "add") {
             // Add an edge to the graph
-            data->graph.addEdge(data->v, data->w, data->weight);
+            data->graph->write([&data](Graph& graph) {
+                graph.addEdge(data->v, data->w, data->weight);
+            });
             data->response = "Edge added from " + std::to_string(data->v) + " to " + std::to_string(data->w) + " with weight " + std::to_string(data->weight) + ".\n";
-            std::cout << "Debug: Edge added from " << data->v << " to " << data->w << " with weight " << data->weight << "." << std::endl;
+            LOG_DEBUG("Edge added from " << data->v << " to " << data->w << " with weight " << data->weight << ".");
 
             // Enqueue response task
             task::enqueueTask(TaskType::Response, data);
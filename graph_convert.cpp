@@ -0,0 +1,88 @@
+// graph_convert.cpp
+//
+// Convert a text edge list into the binary graph file format (graph_file.hpp).
+//
+//   graph_convert <input.txt> <output.graph> [vertices]
+//
+// The input holds one edge per line as "v w weight". Lines starting with '#'
+// are comments. Server command scripts are accepted too: "create V E" sets
+// the vertex count and a leading "add" on edge lines is skipped. Without a
+// vertex count (from the argument or a create line) it is max vertex id + 1.
+
+#include "graph_file.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <input.txt> <output.graph> [vertices]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    long long vertices = argc == 4 ? std::stoll(argv[3]) : -1;
+    std::vector<Edge> edges;
+    int maxVertex = -1;
+    std::string line;
+    size_t lineNumber = 0;
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        std::istringstream iss(line);
+        std::string first;
+        if (!(iss >> first) || first[0] == '#') continue;
+
+        if (first == "create") {
+            long long V;
+            if (!(iss >> V) || V < 0) {
+                std::cerr << argv[1] << ":" << lineNumber << ": invalid create line" << std::endl;
+                return 1;
+            }
+            if (vertices < 0) vertices = V;
+            continue;
+        }
+
+        // Re-read the line without the optional "add" prefix
+        if (first != "add") iss = std::istringstream(line);
+        int v, w, weight;
+        if (!(iss >> v >> w >> weight) || v < 0 || w < 0) {
+            std::cerr << argv[1] << ":" << lineNumber << ": invalid edge line" << std::endl;
+            return 1;
+        }
+        edges.emplace_back(v, w, weight);
+        maxVertex = std::max(maxVertex, std::max(v, w));
+    }
+
+    if (vertices < 0) vertices = maxVertex + 1;
+    if (vertices <= maxVertex || vertices > INT32_MAX) {
+        std::cerr << "Vertex count " << vertices << " does not cover vertex id " << maxVertex << std::endl;
+        return 1;
+    }
+
+    Graph graph(static_cast<int>(vertices));
+    graph.reserveEdges(edges.size());
+    for (const Edge& edge : edges) {
+        graph.addEdge(edge.v, edge.w, edge.weight);
+    }
+
+    try {
+        graphFile::save(argv[2], graph);
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << argv[2] << ": " << vertices << " vertices, " << edges.size() << " edges" << std::endl;
+    return 0;
+}
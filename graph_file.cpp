@@ -0,0 +1,140 @@
+#include "graph_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace graphFile {
+
+static_assert(sizeof(FileHeader) == 32, "graph file header must stay 32 bytes");
+static_assert(sizeof(Edge) == 3 * sizeof(int32_t), "Edge must match the on-disk edge record");
+
+static const size_t RECORD_SIZE = 3 * sizeof(int32_t);
+
+// Edge records interleaved from the graph's arrays per write
+static const size_t RECORDS_PER_WRITE = 4096;
+
+static std::runtime_error ioError(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+// Read-only mapping that is unmapped when it goes out of scope
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw ioError("Cannot open", path);
+
+        struct stat st;
+        if (fstat(fd, &st) < 0) {
+            ::close(fd);
+            throw ioError("Cannot stat", path);
+        }
+        size = static_cast<size_t>(st.st_size);
+        if (size > 0) {
+            data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (data == MAP_FAILED) throw ioError("Cannot map", path);
+        if (size > 0) madvise(data, size, MADV_SEQUENTIAL);
+    }
+
+    ~MappedFile() {
+        if (data != MAP_FAILED && data != nullptr) munmap(data, size);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* bytes() const { return static_cast<const char*>(data); }
+
+    void* data = nullptr;
+    size_t size = 0;
+};
+
+Graph load(const std::string& path, std::shared_ptr<SessionArena> arena) {
+    MappedFile file(path);
+
+    FileHeader header;
+    if (file.size < sizeof(header)) {
+        throw std::runtime_error("Not a graph file: " + path);
+    }
+    std::memcpy(&header, file.bytes(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a graph file: " + path);
+    }
+    if (header.version != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported graph file version " + std::to_string(header.version) + ": " + path);
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw std::runtime_error("Graph file has foreign byte order: " + path);
+    }
+    if (header.vertices > INT_MAX ||
+        header.edges != (file.size - sizeof(header)) / RECORD_SIZE ||
+        (file.size - sizeof(header)) % RECORD_SIZE != 0) {
+        throw std::runtime_error("Corrupt graph file (size does not match header): " + path);
+    }
+
+    Graph graph(static_cast<int>(header.vertices), std::move(arena));
+    graph.reserveEdges(header.edges);
+
+    const char* record = file.bytes() + sizeof(header);
+    for (uint64_t i = 0; i < header.edges; ++i, record += RECORD_SIZE) {
+        int32_t fields[3];
+        std::memcpy(fields, record, RECORD_SIZE);
+        try {
+            graph.addEdge(fields[0], fields[1], fields[2]);
+        } catch (const std::out_of_range&) {
+            throw std::runtime_error("Corrupt graph file (edge " + std::to_string(i) + " out of range): " + path);
+        }
+    }
+    return graph;
+}
+
+void save(const std::string& path, const Graph& graph) {
+    const EdgeArrays& edges = graph.getEdges();
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.vertices = static_cast<uint64_t>(graph.getV());
+    header.edges = edges.size();
+
+    std::string tmpPath = path + ".tmp";
+    FILE* out = std::fopen(tmpPath.c_str(), "wb");
+    if (!out) throw ioError("Cannot create", tmpPath);
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+    std::vector<Edge> records;
+    records.reserve(RECORDS_PER_WRITE);
+    for (size_t first = 0; ok && first < edges.size(); first += RECORDS_PER_WRITE) {
+        records.clear();
+        size_t last = std::min(edges.size(), first + RECORDS_PER_WRITE);
+        for (size_t i = first; i < last; ++i) {
+            records.push_back(edges[i]);
+        }
+        ok = std::fwrite(records.data(), RECORD_SIZE, records.size(), out) == records.size();
+    }
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::runtime_error error = ioError("Cannot write", tmpPath);
+        std::remove(tmpPath.c_str());
+        throw error;
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::runtime_error error = ioError("Cannot rename to", path);
+        std::remove(tmpPath.c_str());
+        throw error;
+    }
+}
+
+} // namespace graphFile
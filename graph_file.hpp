@@ -0,0 +1,44 @@
+#ifndef GRAPH_FILE_HPP
+#define GRAPH_FILE_HPP
+
+#include "graph.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Compact on-disk graph format, loaded with mmap:
+//
+//   char     magic[8]     "MSTGRAPH"
+//   uint32_t version      FORMAT_VERSION
+//   uint32_t byteOrder    BYTE_ORDER_MARK as written by the host
+//   uint64_t vertices
+//   uint64_t edges
+//   edges x { int32_t v, int32_t w, int32_t weight }
+//
+// Integers are in the writer's byte order; a file from a host with the
+// other byte order is rejected rather than silently misread.
+namespace graphFile {
+
+const char MAGIC[8] = {'M', 'S', 'T', 'G', 'R', 'A', 'P', 'H'};
+const uint32_t FORMAT_VERSION = 1;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t vertices;
+    uint64_t edges;
+};
+
+// Map the file and build the graph (in arena, if given) in one pass over
+// the edge array. Throws std::runtime_error for unreadable or malformed files.
+Graph load(const std::string& path, std::shared_ptr<SessionArena> arena = nullptr);
+
+// Write the graph to path (through a temporary file, so readers never see
+// a partial graph). Throws std::runtime_error on I/O failure.
+void save(const std::string& path, const Graph& graph);
+
+} // namespace graphFile
+
+#endif // GRAPH_FILE_HPP
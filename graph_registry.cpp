@@ -0,0 +1,71 @@
+#include "graph_registry.hpp"
+#include "logger.hpp"
+
+SharedGraph::SharedGraph(Graph graph, bool shared)
+    : shared(shared), vertexCount(graph.getV()), published(std::make_shared<GraphSnapshot>(std::move(graph))) {}
+
+SharedGraph::DirtyCheck::~DirtyCheck() {
+    if (owner.working && owner.published && owner.working->getVersion() != owner.published->graph.getVersion()) {
+        owner.dirty.store(true, std::memory_order_release);
+    }
+}
+
+Graph& SharedGraph::workingCopy() {
+    if (!working && !shared && published.use_count() == 1) {
+        // Nobody else holds this version, and snapshot() cannot hand out a
+        // new reference while we hold writeMutex, so take it over. The fence
+        // pairs with the last reader's release of its reference.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        working = std::make_unique<Graph>(std::move(published->graph));
+        std::atomic_store(&published, std::shared_ptr<GraphSnapshot>());
+        dirty.store(true, std::memory_order_release);
+    }
+    if (!working) {
+        GraphSnapshot& current = *published;
+        // A full copy carries over the incremental MST, but a solve may be
+        // building it right now. Otherwise copy only the edges; the clone
+        // can still adopt the tree once that solve offers it (offerMST).
+        std::unique_lock<std::mutex> solving(current.solveMutex, std::try_to_lock);
+        if (solving.owns_lock() && current.graph.hasMaintainedMST()) {
+            working = std::make_unique<Graph>(current.graph);
+        } else {
+            working = std::make_unique<Graph>(current.graph.cloneEdgeSet());
+        }
+    }
+    return *working;
+}
+
+std::shared_ptr<GraphSnapshot> SharedGraph::snapshot() {
+    if (shared && !dirty.load(std::memory_order_acquire)) {
+        return std::atomic_load(&published);
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (dirty.load(std::memory_order_relaxed)) {
+        std::atomic_store(&published, std::make_shared<GraphSnapshot>(std::move(*working)));
+        working.reset();
+        dirty.store(false, std::memory_order_release);
+        LOG_DEBUG("Published graph version " << published->graph.getVersion());
+    }
+    return published;
+}
+
+void SharedGraph::offerMST(const GraphSnapshot& snapshot, const std::vector<Edge>& forestEdges) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (working) {
+        working->adoptMST(snapshot.graph.getVersion(), forestEdges);
+    }
+}
+
+std::shared_ptr<SharedGraph> GraphRegistry::create(const std::string& name, Graph graph) {
+    auto shared = std::make_shared<SharedGraph>(std::move(graph), true);
+    std::lock_guard<std::mutex> lock(mutex);
+    graphs[name] = shared;
+    return shared;
+}
+
+std::shared_ptr<SharedGraph> GraphRegistry::find(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = graphs.find(name);
+    return it == graphs.end() ? nullptr : it->second;
+}
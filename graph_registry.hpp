@@ -0,0 +1,90 @@
+#ifndef GRAPH_REGISTRY_HPP
+#define GRAPH_REGISTRY_HPP
+
+#include "graph.hpp"
+#include "mst_cache.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Immutable published version of a graph. Its edge set never changes, so
+// any number of threads may read it. Solvers still build lazy state in the
+// Graph (CSR, incremental MST), so solves take solveMutex; a second solve
+// of the same snapshot then finds the first one's result in mstCache.
+struct GraphSnapshot {
+    explicit GraphSnapshot(Graph graph) : graph(std::move(graph)) {}
+
+    Graph graph;
+    std::mutex solveMutex;
+    MSTResultCache mstCache; // Guarded by solveMutex
+};
+
+// A graph shared between sessions, copy-on-write style. Readers take the
+// latest snapshot without locking. Writers serialise on writeMutex and
+// mutate a private working copy, cloned from the snapshot by the first
+// write after a publish; the next snapshot() call publishes it by moving
+// it into a new snapshot. Between publishes memory holds one copy per
+// snapshot still referenced, plus the working copy while writes are pending.
+//
+// A private graph (shared = false) has a single session as its writer and
+// hands out snapshots under writeMutex only. When no snapshot is pinned
+// outside the SharedGraph, the first write takes the published graph over
+// instead of cloning it.
+class SharedGraph {
+public:
+    explicit SharedGraph(Graph graph, bool shared = false);
+
+    // Vertex ids writes accept; the vertex count never changes
+    bool hasVertex(int v) const { return v >= 0 && v < vertexCount; }
+
+    // Run fn on the working copy under the writer lock; returns fn's result
+    template <typename Fn>
+    auto write(Fn&& fn) -> decltype(fn(std::declval<Graph&>())) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        DirtyCheck check{*this};
+        return fn(workingCopy());
+    }
+
+    // Latest version, publishing pending writes first
+    std::shared_ptr<GraphSnapshot> snapshot();
+
+    // Hand the spanning forest seeded on snapshot back to the working copy,
+    // so it keeps maintaining it incrementally (see Graph::adoptMST)
+    void offerMST(const GraphSnapshot& snapshot, const std::vector<Edge>& forestEdges);
+
+private:
+    // Marks the graph dirty when a write changed the working copy
+    struct DirtyCheck {
+        SharedGraph& owner;
+        ~DirtyCheck();
+    };
+
+    Graph& workingCopy();
+
+    const bool shared;
+    const int vertexCount;
+    std::mutex writeMutex;
+    std::shared_ptr<GraphSnapshot> published; // Accessed with std::atomic_load/store; null once taken over
+    std::unique_ptr<Graph> working; // Unpublished writes; guarded by writeMutex
+    std::atomic<bool> dirty{false};
+};
+
+// Server-wide table of named graphs
+class GraphRegistry {
+public:
+    // Register graph under name, replacing any graph of that name. Sessions
+    // already using the old graph keep it until they "use" the name again.
+    std::shared_ptr<SharedGraph> create(const std::string& name, Graph graph);
+
+    // nullptr if there is no graph of that name
+    std::shared_ptr<SharedGraph> find(const std::string& name);
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<SharedGraph>> graphs;
+};
+
+#endif // GRAPH_REGISTRY_HPP
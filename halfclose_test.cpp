@@ -0,0 +1,117 @@
+// halfclose_test.cpp
+//
+// Regression test: a client that half-closes its socket right after a large
+// solve must still get the whole reply.
+//
+//   halfclose_test [vertices] [port]
+//
+// For each I/O backend, the server runs in this process and a client sends
+// a path graph as one addbatch, "solve kruskal", and then shutdown(SHUT_WR)
+// before reading anything. The EOF reaches the server while the solve is
+// still running and long before its reply fits in the socket buffers, so
+// the connection has to stay open for output until the reply has drained.
+// Exits non-zero if any backend loses part of the reply.
+
+#include "logger.hpp"
+#include "server.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+
+int connectTo(int port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    // The server thread may still be binding
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        // A small window, so the reply cannot all go out in the server's
+        // first write and has to wait in its output buffer
+        int window = 64 * 1024;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &window, sizeof(window));
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) return fd;
+        close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    std::perror("connect");
+    return -1;
+}
+
+bool sendAll(int fd, const std::string& text) {
+    for (size_t sent = 0; sent < text.size();) {
+        ssize_t n = ::send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            std::perror("send");
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+// One session against a fresh server on the given backend; true if the
+// whole solve reply arrived
+bool runBackend(const std::string& backend, int vertices, int port) {
+    server srv(port, backend);
+    std::thread serverThread([&srv]() { srv.start(); });
+
+    std::string request = "create " + std::to_string(vertices) + " 0\n";
+    request += "addbatch " + std::to_string(vertices - 1) + "\n";
+    for (int v = 1; v < vertices; ++v) {
+        request += std::to_string(v - 1) + " " + std::to_string(v) + " " + std::to_string(v % 100 + 1) + "\n";
+    }
+    request += "solve kruskal\n";
+
+    std::string reply;
+    int fd = connectTo(port);
+    if (fd >= 0) {
+        if (sendAll(fd, request)) {
+            shutdown(fd, SHUT_WR);
+            char buffer[64 * 1024];
+            ssize_t n;
+            while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+                reply.append(buffer, n);
+            }
+        }
+        close(fd);
+    }
+
+    srv.stop();
+    serverThread.join();
+
+    size_t edgeLines = 0;
+    for (size_t pos = reply.find(" -- "); pos != std::string::npos; pos = reply.find(" -- ", pos + 4)) {
+        ++edgeLines;
+    }
+    bool complete = edgeLines == static_cast<size_t>(vertices - 1) &&
+                    reply.find("Average distance between two vertices: ") != std::string::npos;
+    std::printf("%-6s %zu of %d MST edges, %s\n", backend.c_str(), edgeLines, vertices - 1,
+                complete ? "ok" : "FAILED");
+    return complete;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int vertices = argc > 1 ? std::atoi(argv[1]) : 300000;
+    int port = argc > 2 ? std::atoi(argv[2]) : 12398;
+    if (vertices < 2 || port <= 0) {
+        std::fprintf(stderr, "Usage: %s [vertices] [port]\n", argv[0]);
+        return 1;
+    }
+
+    Logger::instance().setLevel(LogLevel::Error);
+    bool ok = runBackend("epoll", vertices, port);
+    // A new port, so the first server's TIME_WAIT sockets do not matter
+    ok = runBackend("uring", vertices, port + 1) && ok;
+    return ok ? 0 : 1;
+}
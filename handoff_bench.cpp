@@ -0,0 +1,124 @@
+// handoff_bench.cpp
+//
+// Microbenchmark of ActiveObject task hand-off, the operation the server's
+// pipeline stages perform on every command.
+//
+//   handoff_bench [hops]
+//
+// relay:  one token passed around a ring of 4 ActiveObjects (like the
+//         commandProcessing -> graphUpdate -> mstComputation -> response
+//         chain); average time per hop while all stages stay busy.
+// wakeup: a task enqueued from outside onto an ActiveObject that has gone
+//         to sleep; time until it runs.
+// flood:  4 producer threads enqueue onto one ActiveObject; tasks/s.
+
+#include "ActiveObject.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double microsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+void relay(long hops) {
+    const int STAGES = 4;
+    std::vector<std::unique_ptr<ActiveObject>> stages;
+    for (int i = 0; i < STAGES; ++i) {
+        stages.push_back(std::make_unique<ActiveObject>());
+    }
+
+    std::atomic<bool> done{false};
+    std::function<void(long)> pass = [&](long remaining) {
+        if (remaining == 0) {
+            done.store(true, std::memory_order_release);
+            return;
+        }
+        stages[remaining % STAGES]->enqueueTask([&pass, remaining]() { pass(remaining - 1); });
+    };
+
+    auto start = Clock::now();
+    pass(hops);
+    while (!done.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    double total = microsSince(start);
+    std::printf("relay: %ld hops over %d stages, %.3f us/hop\n", hops, STAGES, total / hops);
+
+    // Every hop is enqueued from inside a stage task, so once each stage has
+    // run one more task no thread is still in enqueueTask on another stage
+    std::atomic<int> drained{0};
+    for (auto& stage : stages) {
+        stage->enqueueTask([&drained]() { drained.fetch_add(1, std::memory_order_release); });
+    }
+    while (drained.load(std::memory_order_acquire) < STAGES) {
+        std::this_thread::yield();
+    }
+}
+
+void wakeup(int samples) {
+    ActiveObject stage;
+    std::vector<double> latencies;
+    for (int i = 0; i < samples; ++i) {
+        // Long enough for the worker to stop spinning and sleep
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::atomic<bool> ran{false};
+        auto start = Clock::now();
+        stage.enqueueTask([&ran]() { ran.store(true, std::memory_order_release); });
+        while (!ran.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        latencies.push_back(microsSince(start));
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("wakeup: %d samples, p50 %.1f us, p90 %.1f us\n", samples, latencies[samples / 2],
+                latencies[samples * 9 / 10]);
+}
+
+void flood(long tasks) {
+    const int PRODUCERS = 4;
+    std::atomic<long> executed{0};
+    auto start = Clock::now();
+    {
+        ActiveObject stage;
+        std::vector<std::thread> producers;
+        for (int p = 0; p < PRODUCERS; ++p) {
+            producers.emplace_back([&]() {
+                for (long i = 0; i < tasks / PRODUCERS; ++i) {
+                    stage.enqueueTask([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+    } // The destructor runs what is still queued
+    double seconds = microsSince(start) / 1e6;
+    std::printf("flood: %d producers, %ld tasks, %.0f tasks/s\n", PRODUCERS, executed.load(), executed.load() / seconds);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long hops = argc > 1 ? std::atol(argv[1]) : 200000;
+    if (hops < 1) {
+        std::fprintf(stderr, "Usage: %s [hops]\n", argv[0]);
+        return 1;
+    }
+
+    relay(hops);
+    wakeup(200);
+    flood(hops * 5);
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "heap_prim_mst_solver.hpp"
+#include "indexed_heap.hpp"
+#include <memory_resource>
+#include <vector>
+
+std::vector<Edge> HeapPrimMSTSolver::solveMST(Graph& graph) {
+    int V = graph.getV();
+    if (V == 0) return {};
+
+    const CSRGraph& csr = graph.getCSR();
+
+    // Scratch comes from one buffer in the graph's arena, freed in one go
+    std::pmr::monotonic_buffer_resource scratch(V * (5 * sizeof(int) + 1) + 256, graph.resource());
+    std::pmr::vector<int> parent(V, -1, &scratch);
+    std::pmr::vector<bool> inMST(V, false, &scratch);
+    std::pmr::vector<int> key(V, 0, &scratch);
+    std::vector<Edge> mstEdges;
+
+    IndexedDaryHeap<4> heap(V, &scratch);
+    heap.pushOrDecrease(0, 0);
+
+    while (!heap.empty()) {
+        int u = heap.pop();
+        inMST[u] = true;
+        key[u] = heap.keyOf(u);
+
+        for (int i = csr.offsets[u]; i < csr.offsets[u + 1]; ++i) {
+            int v = csr.neighbors[i];
+            int weight = csr.weights[i];
+            if (inMST[v]) continue;
+            if (!heap.contains(v) || weight < heap.keyOf(v)) {
+                heap.pushOrDecrease(v, weight);
+                parent[v] = u;
+            }
+        }
+    }
+
+    // Emit in vertex order, matching PrimMSTSolver
+    for (int i = 1; i < V; ++i) {
+        if (parent[i] != -1) {
+            mstEdges.push_back(Edge(i, parent[i], key[i]));
+        }
+    }
+
+    return mstEdges; // Return the MST edges
+}
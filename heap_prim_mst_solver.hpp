@@ -0,0 +1,14 @@
+#ifndef HEAP_PRIM_MST_SOLVER_HPP
+#define HEAP_PRIM_MST_SOLVER_HPP
+
+#include "prim_mst_solver.hpp"
+#include <vector>
+
+// Prim's algorithm on an indexed 4-ary heap with decrease-key: O(E log V)
+// instead of the O(V^2) Graph::minKey scan. Shares PrimMSTSolver's output format.
+class HeapPrimMSTSolver : public PrimMSTSolver {
+public:
+    std::vector<Edge> solveMST(Graph& graph) override;
+};
+
+#endif // HEAP_PRIM_MST_SOLVER_HPP
@@ -0,0 +1,71 @@
+#include "incremental_mst.hpp"
+#include <algorithm>
+
+IncrementalMST::IncrementalMST(int V, const std::vector<Edge>& forestEdges)
+    : V(V), tree(V + std::max(V - 1, 0)), slotEdges(std::max(V - 1, 0), Edge(0, 0, 0)),
+      slotUsed(std::max(V - 1, 0), false) {
+    // A forest has at most V - 1 edges, so the slots never run out
+    for (int slot = std::max(V - 1, 0) - 1; slot >= 0; --slot) {
+        freeSlots.push_back(slot);
+    }
+    for (const Edge& edge : forestEdges) {
+        attach(edge);
+    }
+}
+
+void IncrementalMST::attach(const Edge& edge) {
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+    slotEdges[slot] = edge;
+    slotUsed[slot] = true;
+    pairs.insert(edgeKey(edge.v, edge.w));
+    byWeight.emplace(edge.weight, slot);
+    ++forestSize;
+
+    int node = V + slot;
+    tree.setValue(node, edge.weight);
+    tree.link(edge.v, node);
+    tree.link(node, edge.w);
+}
+
+void IncrementalMST::detach(int slot) {
+    int node = V + slot;
+    tree.cut(slotEdges[slot].v, node);
+    tree.cut(node, slotEdges[slot].w);
+    slotUsed[slot] = false;
+    pairs.erase(edgeKey(slotEdges[slot].v, slotEdges[slot].w));
+    byWeight.erase({slotEdges[slot].weight, slot});
+    freeSlots.push_back(slot);
+    --forestSize;
+}
+
+void IncrementalMST::insert(const Edge& edge) {
+    if (edge.v == edge.w) return; // A self-loop never belongs to a spanning tree
+
+    if (!tree.connected(edge.v, edge.w)) {
+        attach(edge);
+        return;
+    }
+
+    // Vertex nodes hold INT_MIN, so the maximum on the path is an edge node
+    int heaviest = tree.pathMax(edge.v, edge.w);
+    if (tree.value(heaviest) > edge.weight) {
+        detach(heaviest - V);
+        attach(edge);
+    }
+}
+
+bool IncrementalMST::containsEdge(int v, int w) const {
+    // A forest never holds two edges between the same pair of vertices
+    return pairs.count(edgeKey(v, w)) != 0;
+}
+
+std::vector<Edge> IncrementalMST::edges() const {
+    std::vector<Edge> result;
+    result.reserve(forestSize);
+    // Weight order, like the edge-based solvers; ties in slot order
+    for (const auto& entry : byWeight) {
+        result.push_back(slotEdges[entry.second]);
+    }
+    return result;
+}
@@ -0,0 +1,45 @@
+#ifndef INCREMENTAL_MST_HPP
+#define INCREMENTAL_MST_HPP
+
+#include "graph.hpp"
+#include "link_cut_tree.hpp"
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Minimum spanning forest kept up to date under edge insertion.
+// Vertices are link-cut tree nodes 0..V-1 and every forest edge is its own
+// node V + slot carrying the edge weight, so a path-maximum query finds the
+// heaviest edge on a tree path. Inserting v-w either links two components
+// or, if it closes a cycle, replaces the heaviest edge on the v..w path when
+// that edge is heavier (cycle property). Both cost amortised O(log V).
+class IncrementalMST {
+public:
+    // Start from a minimum spanning forest of the current graph
+    IncrementalMST(int V, const std::vector<Edge>& forestEdges);
+
+    void insert(const Edge& edge);
+
+    // Whether some forest edge joins v and w (O(1))
+    bool containsEdge(int v, int w) const;
+
+    // Current forest edges, ordered by weight (O(V), no sorting)
+    std::vector<Edge> edges() const;
+    size_t size() const { return forestSize; }
+
+private:
+    void attach(const Edge& edge);
+    void detach(int slot);
+
+    int V;
+    LinkCutTree tree;
+    std::vector<Edge> slotEdges; // Edge stored in node V + slot
+    std::vector<bool> slotUsed;
+    std::vector<int> freeSlots;
+    std::unordered_set<uint64_t> pairs; // edgeKey of every forest edge
+    std::set<std::pair<int, int>> byWeight; // (weight, slot) of every forest edge
+    size_t forestSize = 0;
+};
+
+#endif // INCREMENTAL_MST_HPP
@@ -0,0 +1,90 @@
+#ifndef INDEXED_HEAP_HPP
+#define INDEXED_HEAP_HPP
+
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+// Indexed D-ary min-heap over ids 0..n-1 with integer keys.
+// Supports decrease-key in O(log_D n) through a position index, which is
+// what Prim's algorithm needs to stay O(E log V).
+template <int D = 4>
+class IndexedDaryHeap {
+public:
+    explicit IndexedDaryHeap(int n, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : heap(resource), pos(n, -1, resource), keys(n, resource) {
+        heap.reserve(n);
+    }
+
+    bool empty() const { return heap.empty(); }
+    bool contains(int id) const { return pos[id] != -1; }
+    int keyOf(int id) const { return keys[id]; }
+
+    // Insert id with the given key, or lower its key if it is already queued
+    void pushOrDecrease(int id, int key) {
+        if (pos[id] == -1) {
+            keys[id] = key;
+            pos[id] = static_cast<int>(heap.size());
+            heap.push_back(id);
+            siftUp(pos[id]);
+        } else if (key < keys[id]) {
+            keys[id] = key;
+            siftUp(pos[id]);
+        }
+    }
+
+    // Remove and return the id with the smallest key
+    int pop() {
+        int top = heap[0];
+        int last = heap.back();
+        heap.pop_back();
+        pos[top] = -1;
+        if (!heap.empty()) {
+            heap[0] = last;
+            pos[last] = 0;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    void siftUp(int i) {
+        int id = heap[i];
+        while (i > 0) {
+            int p = (i - 1) / D;
+            if (keys[heap[p]] <= keys[id]) break;
+            heap[i] = heap[p];
+            pos[heap[i]] = i;
+            i = p;
+        }
+        heap[i] = id;
+        pos[id] = i;
+    }
+
+    void siftDown(int i) {
+        int id = heap[i];
+        int n = static_cast<int>(heap.size());
+        while (true) {
+            int first = i * D + 1;
+            if (first >= n) break;
+            int last = std::min(first + D, n);
+            int best = first;
+            for (int c = first + 1; c < last; ++c) {
+                if (keys[heap[c]] < keys[heap[best]]) best = c;
+            }
+            if (keys[heap[best]] >= keys[id]) break;
+            heap[i] = heap[best];
+            pos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = id;
+        pos[id] = i;
+    }
+
+    std::pmr::vector<int> heap; // Heap-ordered ids
+    std::pmr::vector<int> pos;  // Position of each id in heap, -1 if absent
+    std::pmr::vector<int> keys; // Current key of each id
+};
+
+#endif // INDEXED_HEAP_HPP
@@ -0,0 +1,104 @@
+#ifndef INLINE_TASK_HPP
+#define INLINE_TASK_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Move-only type-erased void() callable for handing work between threads.
+// Callables up to INLINE_SIZE bytes (every lambda the pipeline stages pass,
+// e.g. a shared_ptr session, a sequence number and a reply string) live in
+// the object itself, so wrapping one costs no allocation and moving it moves
+// the captures instead of copying them. Larger callables go to the heap.
+class InlineTask {
+public:
+    static constexpr size_t INLINE_SIZE = 96;
+
+    InlineTask() noexcept = default;
+
+    template <typename Fn,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<Fn>, InlineTask>::value>>
+    InlineTask(Fn&& fn) {
+        using Callable = std::decay_t<Fn>;
+        if (fitsInline<Callable>()) {
+            new (storage) Callable(std::forward<Fn>(fn));
+            ops = &inlineOps<Callable>;
+        } else {
+            *reinterpret_cast<Callable**>(storage) = new Callable(std::forward<Fn>(fn));
+            ops = &heapOps<Callable>;
+        }
+    }
+
+    InlineTask(InlineTask&& other) noexcept : ops(other.ops) {
+        if (ops) {
+            ops->move(other.storage, storage);
+            other.ops = nullptr;
+        }
+    }
+
+    InlineTask& operator=(InlineTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops) {
+                other.ops->move(other.storage, storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    InlineTask(const InlineTask&) = delete;
+    InlineTask& operator=(const InlineTask&) = delete;
+
+    ~InlineTask() { reset(); }
+
+    void operator()() { ops->invoke(storage); }
+
+    explicit operator bool() const noexcept { return ops != nullptr; }
+
+    // Destroy the callable (and release its captures) now
+    void reset() noexcept {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* from, void* to) noexcept; // Leaves from destroyed
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename Callable>
+    static constexpr bool fitsInline() {
+        return sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible<Callable>::value;
+    }
+
+    template <typename Callable>
+    static constexpr Ops inlineOps = {
+        [](void* storage) { (*static_cast<Callable*>(storage))(); },
+        [](void* from, void* to) noexcept {
+            Callable* source = static_cast<Callable*>(from);
+            new (to) Callable(std::move(*source));
+            source->~Callable();
+        },
+        [](void* storage) noexcept { static_cast<Callable*>(storage)->~Callable(); },
+    };
+
+    template <typename Callable>
+    static constexpr Ops heapOps = {
+        [](void* storage) { (**static_cast<Callable**>(storage))(); },
+        [](void* from, void* to) noexcept { *static_cast<Callable**>(to) = *static_cast<Callable**>(from); },
+        [](void* storage) noexcept { delete *static_cast<Callable**>(storage); },
+    };
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    const Ops* ops = nullptr;
+};
+
+#endif // INLINE_TASK_HPP
@@ -0,0 +1,16 @@
+#include "io_backend.hpp"
+#include "reactor.hpp"
+#include "uring_backend.hpp"
+#include "logger.hpp"
+
+std::unique_ptr<IOBackend> createIOBackend(const std::string& name, int port, ConnectionHandler& handler) {
+    if (name == "uring") {
+        if (UringBackend::isSupported()) {
+            return std::make_unique<UringBackend>(port, handler);
+        }
+        LOG_WARN("io_uring is not available on this kernel, falling back to epoll");
+    } else if (name != "epoll") {
+        LOG_WARN("Unknown I/O backend '" << name << "', using epoll");
+    }
+    return std::make_unique<Reactor>(port, handler);
+}
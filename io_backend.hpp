@@ -0,0 +1,33 @@
+#ifndef IO_BACKEND_HPP
+#define IO_BACKEND_HPP
+
+#include "connection.hpp"
+#include <memory>
+#include <string>
+
+// Event loop that owns the listening socket and every client connection and
+// reports to a ConnectionHandler. Implemented by Reactor (epoll) and
+// UringBackend (io_uring).
+class IOBackend {
+public:
+    virtual ~IOBackend() = default;
+
+    // Create the listening socket; false (after logging) on failure
+    virtual bool open() = 0;
+
+    // Run the event loop on the calling thread until stop() is called
+    virtual void run() = 0;
+
+    // Thread-safe: wake the loop and make run() return
+    virtual void stop() = 0;
+
+    // Thread-safe: have the loop ask the handler again about the connections
+    // it holds back: paused ones (onData) and closing ones (hasPendingWork)
+    virtual void recheckConnections() = 0;
+};
+
+// Build the backend named "epoll" or "uring". io_uring falls back to epoll
+// (with a warning) when the kernel does not support what it needs.
+std::unique_ptr<IOBackend> createIOBackend(const std::string& name, int port, ConnectionHandler& handler);
+
+#endif // IO_BACKEND_HPP
@@ -1,81 +1,87 @@
 // kruskal_mst_solver.cpp
 
 #include "kruskal_mst_solver.hpp"
+#include "dsu.hpp"
+#include "edge_sort.hpp"
+#include "logger.hpp"
 #include <algorithm>
 #include <iostream>
+#include <memory_resource>
 #include <sstream>
 
-class DSU {
-    std::vector<int> parent, rank;
+namespace {
 
-public:
-    DSU(int n) : parent(n, -1), rank(n, 1) {}
+// How many sorted edges ahead to prefetch endpoints; far enough to cover a
+// cache miss, near enough that the lines are still resident when used
+const size_t PREFETCH_DISTANCE = 8;
 
-    // Find with path compression
-    int find(int i) {
-        if (parent[i] == -1) return i;
-        return parent[i] = find(parent[i]);
-    }
-
-    // Union by rank
-    void unite(int x, int y) {
-        int s1 = find(x);
-        int s2 = find(y);
-        if (s1 != s2) {
-            if (rank[s1] < rank[s2]) parent[s1] = s2;
-            else if (rank[s1] > rank[s2]) parent[s2] = s1;
-            else { parent[s2] = s1; rank[s1]++; }
-        }
-    }
-};
+} // namespace
 
 std::vector<Edge> KruskalMSTSolver::solveMST(Graph& graph) {
-    auto edges = graph.getEdges();
     int V = graph.getV();  // Number of vertices
 
     // Handle the case of an empty graph
-    if (V == 0 || edges.empty()) {
-        std::cout << "Graph is empty!" << std::endl;
+    if (V == 0 || graph.getEdges().empty()) {
+        LOG_INFO("Graph is empty!");
         return {};
     }
 
-    std::cout << "Number of vertices: " << V << std::endl;
-    std::cout << "Edges in the graph:\n";
-    for (const auto& edge : edges) {
-        std::cout << edge.v << " -- " << edge.w << " == " << edge.weight << std::endl;
+    std::vector<Edge> mstEdges = spanningForest(graph);
+
+    // Check if we found a valid MST (if the graph was disconnected, MST will be incomplete)
+    if (mstEdges.size() != static_cast<size_t>(V - 1)) {
+        LOG_INFO("Graph is disconnected! No valid MST found.");
+        return {};  // Return an empty MST to signify failure
     }
 
-    // Sort edges by weight
-    std::sort(edges.begin(), edges.end());
+    return mstEdges;
+}
+
+std::vector<Edge> KruskalMSTSolver::spanningForest(Graph& graph) {
+    const EdgeArrays& graphEdges = graph.getEdges();
+    int V = graph.getV();  // Number of vertices
+    if (V == 0 || graphEdges.empty()) return {};
+
+    LOG_DEBUG("Number of vertices: " << V << ", edges in the graph: " << graphEdges.size());
+
+    // Scratch comes from one buffer in the graph's arena, freed in one go
+    std::pmr::monotonic_buffer_resource scratch(2 * graphEdges.size() * sizeof(uint64_t) + 2 * V * sizeof(int) + 256,
+                                                graph.resource());
+
+    // Sort (weight, index) keys, radix/counting sort when the weights allow it
+    std::pmr::vector<uint64_t> keys = sortedWeightKeys(graphEdges.weight, &scratch);
 
     // Disjoint Set Union (DSU) for cycle detection
-    DSU dsu(V);
+    DSU dsu(V, &scratch);
     std::vector<Edge> mstEdges;
 
-    // Iterate over the sorted edges
-    for (const Edge& edge : edges) {
-        std::cout << "Processing edge: " << edge.v << " -- " << edge.w << " == " << edge.weight << std::endl;
+    // Iterate over the edges in weight order, fetching only the endpoints
+    for (size_t k = 0; k < keys.size(); ++k) {
+        // Endpoints are gathered out of order; start loading a few edges ahead
+        if (k + PREFETCH_DISTANCE < keys.size()) {
+            uint32_t ahead = keyIndex(keys[k + PREFETCH_DISTANCE]);
+            __builtin_prefetch(&graphEdges.src[ahead]);
+            __builtin_prefetch(&graphEdges.dst[ahead]);
+        }
+        uint64_t key = keys[k];
+        uint32_t index = keyIndex(key);
+        Edge edge(graphEdges.src[index], graphEdges.dst[index], keyWeight(key));
+        LOG_DEBUG("Processing edge: " << edge.v << " -- " << edge.w << " == " << edge.weight);
         // Check if the current edge forms a cycle
         if (dsu.find(edge.v) != dsu.find(edge.w)) {
             dsu.unite(edge.v, edge.w);
             mstEdges.push_back(edge);
-            std::cout << "Added to MST: " << edge.v << " -- " << edge.w << std::endl;
+            LOG_DEBUG("Added to MST: " << edge.v << " -- " << edge.w);
         }
         // Stop if MST is complete (contains V-1 edges)
-        if (mstEdges.size() == V - 1) break;
-    }
-
-    // Check if we found a valid MST (if the graph was disconnected, MST will be incomplete)
-    if (mstEdges.size() != V - 1) {
-        std::cout << "Graph is disconnected! No valid MST found." << std::endl;
-        return {};  // Return an empty MST to signify failure
+        if (mstEdges.size() == static_cast<size_t>(V - 1)) break;
     }
 
     return mstEdges;
 }
 
 
-std::string KruskalMSTSolver::getMSTResults(Graph& graph, const std::vector<Edge>& mstEdges) {
+std::string KruskalMSTSolver::formatResults(const std::vector<Edge>& mstEdges, const MSTStatistics& stats) {
     std::ostringstream oss;
 
     // Handle the case where the MST is empty or invalid
@@ -90,16 +96,10 @@ std::string KruskalMSTSolver::getMSTResults(Graph& graph, const std::vector<Edge
         oss << edge.v << " -- " << edge.w << " == " << edge.weight << "\n";
     }
 
-    // Calculate additional statistics about the MST
-    int totalWeight = graph.calculateTotalWeight(mstEdges);
-    int longestDistance = graph.findLongestDistance(mstEdges);
-    int shortestDistance = graph.findShortestDistance(mstEdges);
-    double averageDistance = graph.calculateAverageDistance(mstEdges);
-
-    oss << "Total weight of the MST: " << totalWeight << std::endl;
-    oss << "Longest distance between two vertices: " << longestDistance << std::endl;
-    oss << "Shortest distance between two vertices: " << shortestDistance << std::endl;
-    oss << "Average distance between two vertices: " << averageDistance << std::endl;
+    oss << "Total weight of the MST: " << stats.totalWeight << std::endl;
+    oss << "Longest distance between two vertices: " << stats.longestDistance << std::endl;
+    oss << "Shortest distance between two vertices: " << stats.shortestDistance << std::endl;
+    oss << "Average distance between two vertices: " << stats.averageDistance << std::endl;
 
     return oss.str();
 }
\ No newline at end of file
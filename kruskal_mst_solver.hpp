@@ -7,7 +7,11 @@
 class KruskalMSTSolver : public MSTSolver {
 public:
     std::vector<Edge> solveMST(Graph& graph) override; // Change return type to std::vector<Edge>
-    std::string getMSTResults(Graph& graph, const std::vector<Edge>& mstEdges) override;
+
+    // Minimum spanning forest: the MST of every component, also when the
+    // graph is disconnected (where solveMST reports no MST)
+    static std::vector<Edge> spanningForest(Graph& graph);
+    std::string formatResults(const std::vector<Edge>& mstEdges, const MSTStatistics& stats) override;
 };
 
 #endif // KRUSKAL_MST_SOLVER_HPP
\ No newline at end of file
@@ -1,243 +1,378 @@
 #include "mst_solver.hpp"
 #include "mst_factory.hpp"
-#include <iostream>
+#include "logger.hpp"
+#include "connection.hpp"
 #include <sstream>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
-#include <cstring>
-#include <queue>
+#include <atomic>
+#include <stdexcept>
+#include <unordered_set>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
 #include <vector>
 #include <memory>
-#include <functional>
 
-// Represents data shared between threads for a client
+// Local to this binary: the names clash with the ActiveObject pipeline's
+// pipelineData and server classes.
+namespace {
+
+const size_t READ_CHUNK = 64 * 1024;
+
+// Represents data shared between threads for a client. Only the thread
+// holding the socket's (one-shot) event touches it, so it needs no lock.
 struct pipelineData {
     int client_fd;
     std::string command;
     std::string response;
+    std::shared_ptr<SessionArena> arena; // Backs graph; see SessionArena
     Graph graph;
     std::string algorithm;
-    pipelineData() : graph(0) {}
+    std::shared_ptr<Connection> connection;
+    bool readClosed = false; // Peer sent EOF; stay until output drains
 
-};
+    pipelineData() : arena(std::make_shared<SessionArena>()), graph(0, arena) {}
 
-// Leader-Follower thread pool implementation
-class LeaderFollowerThreadPool {
-private:
-    std::queue<std::function<void()>> taskQueue;
-    std::vector<std::thread> threads;
-    std::mutex queueMutex;
-    std::condition_variable taskAvailable;
-    bool shutdown = false;
+};
 
+// Leader/Followers server (Schmidt et al.). The listening socket and every
+// client socket form one handle set registered with epoll, each client with
+// EPOLLONESHOT. The threads take turns as leader: the leader alone waits in
+// epoll_wait for one event, then promotes the next follower by giving up the
+// leader lock and processes the event itself, so there is no queue hand-off
+// between the thread that saw the event and the one that handles it. A
+// one-shot handle is disabled until its handler re-arms it, so each client's
+// commands run in order on one thread at a time.
+class server {
 public:
-    LeaderFollowerThreadPool(size_t numThreads) {
-        for (size_t i = 0; i < numThreads; ++i) {
-            threads.emplace_back(&LeaderFollowerThreadPool::workerThread, this);
-        }
-    }
-
-    ~LeaderFollowerThreadPool() {
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            shutdown = true;
-        }
-        taskAvailable.notify_all();
-
-        for (auto &t : threads) {
-            if (t.joinable()) {
-                t.join();
-            }
-        }
-    }
-
-    void addTask(std::function<void()> task) {
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            taskQueue.push(task);
-        }
-        taskAvailable.notify_one();  // Notify one waiting thread
-    }
+    server(int port, unsigned numThreads);
+    ~server();
+    void start();
+    void stop(); // Async-signal-safe: only sets a flag and writes the eventfd
 
 private:
-    void workerThread() {
-        while (true) {
-            std::function<void()> task;
+    void followerLoop();
+    void acceptClients();
+    void handleClient(pipelineData* data, uint32_t events);
+    bool readClient(pipelineData* data);
+    void rearm(pipelineData* data);
+    void dropClient(pipelineData* data, bool failed);
+    void handleCommand(pipelineData* data, const std::string& command);
 
-            {
-                std::unique_lock<std::mutex> lock(queueMutex);
-                taskAvailable.wait(lock, [this]() { return !taskQueue.empty() || shutdown; });
+    int port;
+    unsigned numThreads;
+    int listenFd;
+    int epollFd;
+    int wakeFd; // eventfd used by stop()
+    std::atomic<bool> stopping;
 
-                if (shutdown && taskQueue.empty()) {
-                    return;
-                }
+    std::mutex leaderMutex; // Held by the leader while it waits for an event
 
-                task = taskQueue.front();
-                taskQueue.pop();
-            }
+    std::mutex sessionsMutex;
+    std::unordered_set<pipelineData*> sessions; // Owned; freed on disconnect
 
-            if (task) {
-                task();
-            }
-        }
-    }
+    // epoll_event.data.ptr of the two handles that are not clients
+    static char listenTag;
+    static char wakeTag;
 };
 
-// Server class definition
-class server {
-public:
-    server(int port);
-    void start();
-    void stop();
+char server::listenTag;
+char server::wakeTag;
 
-private:
-    int port;
-    LeaderFollowerThreadPool threadPool {4};  // Pool with 4 threads
+server::server(int port, unsigned numThreads)
+    : port(port), numThreads(numThreads ? numThreads : 1), listenFd(-1), epollFd(-1), wakeFd(-1), stopping(false) {}
 
-    void handleClient(int client_fd, std::shared_ptr<pipelineData> data);
-};
-
-server::server(int port) : port(port) {}
+server::~server() {
+    for (pipelineData* data : sessions) {
+        data->connection->markClosed();
+        delete data;
+    }
+    if (listenFd != -1) close(listenFd);
+    if (epollFd != -1) close(epollFd);
+    if (wakeFd != -1) close(wakeFd);
+}
 
 void server::start() {
-    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd == -1) {
-        perror("socket failed");
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd == -1) {
+        LOG_ERROR("socket failed: " << std::strerror(errno));
         return;
     }
 
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
     sockaddr_in server_addr{};
     server_addr.sin_family = AF_INET;
     server_addr.sin_addr.s_addr = INADDR_ANY;
     server_addr.sin_port = htons(port);
 
-    if (bind(server_fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
-        perror("bind failed");
-        close(server_fd);
+    if (bind(listenFd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
+        LOG_ERROR("bind failed: " << std::strerror(errno));
+        return;
+    }
+    if (listen(listenFd, SOMAXCONN) < 0) {
+        LOG_ERROR("listen failed: " << std::strerror(errno));
         return;
     }
 
-    if (listen(server_fd, 3) < 0) {
-        perror("listen failed");
-        close(server_fd);
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd == -1 || wakeFd == -1) {
+        LOG_ERROR("epoll setup failed: " << std::strerror(errno));
         return;
     }
 
-    std::cout << "Server is listening on port " << port << std::endl;
+    // The listening socket is one-shot too: one thread accepts at a time.
+    // The wake eventfd stays level-triggered so every leader in turn sees it.
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = &listenTag;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.events = EPOLLIN;
+    ev.data.ptr = &wakeTag;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    LOG_INFO("Server is listening on port " << port << " (leader/followers, " << numThreads << " threads)");
+
+    std::vector<std::thread> followers;
+    for (unsigned i = 1; i < numThreads; ++i) {
+        followers.emplace_back(&server::followerLoop, this);
+    }
+    followerLoop();
+    for (std::thread& follower : followers) {
+        follower.join();
+    }
+}
+
+void server::stop() {
+    stopping.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    if (wakeFd != -1 && write(wakeFd, &one, sizeof(one)) < 0) {
+        // Nothing to do: the counter is already non-zero, the leaders will wake
+    }
+}
+
+void server::followerLoop() {
+    while (true) {
+        epoll_event event;
+        int n;
+        {
+            // Followers queue on the leader lock; releasing it promotes one
+            std::lock_guard<std::mutex> leader(leaderMutex);
+            if (stopping.load(std::memory_order_acquire)) return;
+            n = epoll_wait(epollFd, &event, 1, -1);
+        }
+
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("epoll_wait failed: " << std::strerror(errno));
+            return;
+        }
+        if (n == 0 || event.data.ptr == &wakeTag) continue;
+
+        if (event.data.ptr == &listenTag) {
+            acceptClients();
+        } else {
+            handleClient(static_cast<pipelineData*>(event.data.ptr), event.events);
+        }
+    }
+}
 
+void server::acceptClients() {
     while (true) {
         sockaddr_in client_addr;
         socklen_t client_len = sizeof(client_addr);
-        int client_fd = accept(server_fd, (struct sockaddr *)&client_addr, &client_len);
+        int client_fd = accept4(listenFd, (struct sockaddr *)&client_addr, &client_len,
+                                SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (client_fd < 0) {
-            perror("accept failed");
-            continue;
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("accept failed: " << std::strerror(errno));
+            }
+            break;
         }
 
-        std::cout << "Accepted client connection. Client FD: " << client_fd << std::endl;
+        int nodelay = 1;
+        setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
 
-        auto data = std::make_shared<pipelineData>();
+        auto data = new pipelineData();
         data->client_fd = client_fd;
+        data->connection = std::make_shared<Connection>(client_fd);
+        {
+            std::lock_guard<std::mutex> lock(sessionsMutex);
+            sessions.insert(data);
+        }
 
-        threadPool.addTask([this, client_fd, data]() { handleClient(client_fd, data); });
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        ev.data.ptr = data;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, client_fd, &ev) < 0) {
+            LOG_ERROR("epoll_ctl failed: " << std::strerror(errno));
+            std::lock_guard<std::mutex> lock(sessionsMutex);
+            sessions.erase(data);
+            delete data; // The connection's destructor closes the socket
+            continue;
+        }
+        LOG_INFO("Accepted client connection. Client FD: " << client_fd);
     }
 
-    close(server_fd);
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = &listenTag;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, listenFd, &ev);
 }
 
-void server::stop() {
-    std::cout << "Stopping server..." << std::endl;
+void server::handleClient(pipelineData* data, uint32_t events) {
+    if (events & EPOLLOUT) {
+        data->connection->flushPending();
+    }
+    if (!data->readClosed && (events & (EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLRDHUP))) {
+        if (!readClient(data)) {
+            dropClient(data, true);
+            return;
+        }
+    }
+
+    // After EOF, responses still buffered are delivered (the client may only
+    // have half-closed) before the session goes away
+    if (data->connection->isClosed() || (data->readClosed && !data->connection->hasPendingOutput())) {
+        dropClient(data, false);
+        return;
+    }
+    rearm(data);
 }
 
-void server::handleClient(int client_fd, std::shared_ptr<pipelineData> data) {
-    char buffer[1024];
+bool server::readClient(pipelineData* data) {
+    Connection& conn = *data->connection;
+    char buffer[READ_CHUNK];
+
     while (true) {
-        memset(buffer, 0, sizeof(buffer));
-        int bytes_read = read(client_fd, buffer, sizeof(buffer) - 1);
+        ssize_t bytes_read = read(conn.fd(), buffer, sizeof(buffer));
         if (bytes_read > 0) {
-            buffer[bytes_read] = '\0';
-            std::string command(buffer);
-            std::cout << "Received command: " << command << std::endl;
-
-            std::istringstream iss(command);
-            std::string cmd;
-            iss >> cmd;
-            data->command = cmd;
-
-            if (cmd == "create") {
-                int V, E;
-                if (iss >> V >> E) {
-                    data->graph = Graph(V);
-                    data->response = "Graph created with " + std::to_string(V) + " vertices and " + std::to_string(E) + " edges.\n";
-                    threadPool.addTask([data]() {
-                        write(data->client_fd, data->response.c_str(), data->response.length());
-                    });
-                } else {
-                    data->response = "Invalid input for create command.\n";
-                    threadPool.addTask([data]() {
-                        write(data->client_fd, data->response.c_str(), data->response.length());
-                    });
-                }
-            } else if (cmd == "add") {
-                int v, w, weight;
-                if (iss >> v >> w >> weight) {
-                    data->graph.addEdge(v, w, weight);
-                    data->response = "Edge added: " + std::to_string(v) + " -> " + std::to_string(w) + " with weight " + std::to_string(weight) + ".\n";
-                    threadPool.addTask([data]() {
-                        write(data->client_fd, data->response.c_str(), data->response.length());
-                    });
-                } else {
-                    data->response = "Invalid input for add command.\n";
-                    threadPool.addTask([data]() {
-                        write(data->client_fd, data->response.c_str(), data->response.length());
-                    });
-                }
-            } else if (cmd == "solve") {
-                std::string algo;
-                if (iss >> algo) {
-                    data->algorithm = algo;
-
-                    threadPool.addTask([this, data]() {
-                        MSTAlgorithmType algoType = (data->algorithm == "prim") ? PRIM : KRUSKAL;
-                        auto solver = MSTFactory::createSolver(algoType);
-
-                        std::vector<Edge> mstEdges = solver->solveMST(data->graph);
-
-                        data->response = solver->getMSTResults(data->graph, mstEdges);
-                        threadPool.addTask([data]() {
-                            write(data->client_fd, data->response.c_str(), data->response.length());
-                        });
-                    });
-                } else {
-                    data->response = "Invalid input for solve command.\n";
-                    threadPool.addTask([data]() {
-                        write(data->client_fd, data->response.c_str(), data->response.length());
-                    });
-                }
-            } else {
-                data->response = "Unknown command.\n";
-                threadPool.addTask([data]() {
-                    write(data->client_fd, data->response.c_str(), data->response.length());
-                });
+            conn.inBuf.append(buffer, bytes_read);
+            std::string line;
+            while (conn.nextLine(line)) {
+                if (!line.empty()) handleCommand(data, line);
             }
+        } else if (bytes_read == 0) {
+            LOG_INFO("Client disconnected. Client FD: " << conn.fd());
+            data->readClosed = true;
+            return true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        } else {
+            LOG_ERROR("Failed to read from fd " << conn.fd() << ": " << std::strerror(errno));
+            return false;
+        }
+    }
+}
+
+void server::rearm(pipelineData* data) {
+    // Level-triggered: unread input or a writable socket fires again at once.
+    // Ask for EPOLLOUT only while output is buffered, or it would never stop.
+    epoll_event ev{};
+    ev.events = EPOLLONESHOT;
+    if (!data->readClosed) ev.events |= EPOLLIN | EPOLLRDHUP;
+    if (data->connection->hasPendingOutput()) ev.events |= EPOLLOUT;
+    ev.data.ptr = data;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, data->client_fd, &ev) < 0) {
+        LOG_ERROR("epoll_ctl failed: " << std::strerror(errno));
+        dropClient(data, true);
+    }
+}
+
+void server::dropClient(pipelineData* data, bool failed) {
+    // No other thread can hold this handle: its one-shot event was taken
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, data->client_fd, nullptr);
+    if (failed) data->connection->markClosed();
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        sessions.erase(data);
+    }
+    delete data;
+}
+
+void server::handleCommand(pipelineData* data, const std::string& command) {
+    LOG_DEBUG("Received command: " << command);
+
+    std::istringstream iss(command);
+    std::string cmd;
+    iss >> cmd;
+    data->command = cmd;
+
+    if (cmd == "create") {
+        int V, E;
+        if (iss >> V >> E) {
+            data->graph = Graph(V, data->arena);
+            data->connection->send("Graph created with " + std::to_string(V) + " vertices and " + std::to_string(E) + " edges.\n");
         } else {
-            if (bytes_read == 0) {
-                std::cout << "Client disconnected. Client FD: " << client_fd << std::endl;
-                close(client_fd);
-                break;
-            } else {
-                perror("Failed to read from fd");
+            data->connection->send("Invalid input for create command.\n");
+        }
+    } else if (cmd == "add") {
+        int v, w, weight;
+        if (iss >> v >> w >> weight) {
+            try {
+                data->graph.addEdge(v, w, weight);
+                data->connection->send("Edge added: " + std::to_string(v) + " -> " + std::to_string(w) + " with weight " + std::to_string(weight) + ".\n");
+            } catch (const std::out_of_range& e) {
+                data->connection->send(std::string(e.what()) + ".\n");
             }
+        } else {
+            data->connection->send("Invalid input for add command.\n");
         }
+    } else if (cmd == "solve") {
+        std::string algo;
+        if (iss >> algo) {
+            data->algorithm = algo;
+
+            MSTAlgorithmType algoType = MSTFactory::algorithmFromName(data->algorithm);
+            auto solver = MSTFactory::createSolver(algoType);
+
+            std::vector<Edge> mstEdges = solver->solve(data->graph);
+
+            data->connection->send(solver->getMSTResults(data->graph, mstEdges));
+        } else {
+            data->connection->send("Invalid input for solve command.\n");
+        }
+    } else {
+        data->connection->send("Unknown command.\n");
     }
 }
 
-int main() {
-    server srv(8080);  // Set server to listen on port 8080
+// Server instance stopped by the signal handler
+server* runningServer = nullptr;
+
+void signalHandler(int) {
+    if (runningServer) runningServer->stop();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Optional: --threads N sets the size of the leader/followers pool
+    unsigned numThreads = 4;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--threads") {
+            numThreads = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+    }
+
+    server srv(8080, numThreads);  // Set server to listen on port 8080
+    runningServer = &srv;
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
     srv.start();
+    LOG_INFO("Server stopped");
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,134 @@
+#include "link_cut_tree.hpp"
+#include <climits>
+#include <utility>
+
+LinkCutTree::LinkCutTree(int n) : nodes(n) {
+    for (int x = 0; x < n; ++x) {
+        nodes[x] = Node{{-1, -1}, -1, INT_MIN, x, false};
+    }
+}
+
+void LinkCutTree::setValue(int x, int value) {
+    nodes[x].value = value;
+    nodes[x].maxNode = x;
+}
+
+bool LinkCutTree::isSplayRoot(int x) const {
+    int p = nodes[x].parent;
+    return p == -1 || (nodes[p].child[0] != x && nodes[p].child[1] != x);
+}
+
+void LinkCutTree::pull(int x) {
+    Node& node = nodes[x];
+    node.maxNode = x;
+    for (int c : node.child) {
+        if (c != -1 && nodes[nodes[c].maxNode].value > nodes[node.maxNode].value) {
+            node.maxNode = nodes[c].maxNode;
+        }
+    }
+}
+
+void LinkCutTree::push(int x) {
+    Node& node = nodes[x];
+    if (!node.reversed) return;
+    std::swap(node.child[0], node.child[1]);
+    for (int c : node.child) {
+        if (c != -1) nodes[c].reversed = !nodes[c].reversed;
+    }
+    node.reversed = false;
+}
+
+void LinkCutTree::rotate(int x) {
+    int y = nodes[x].parent;
+    int z = nodes[y].parent;
+    int side = nodes[y].child[1] == x;
+
+    if (!isSplayRoot(y)) {
+        nodes[z].child[nodes[z].child[1] == y] = x;
+    }
+    nodes[x].parent = z;
+
+    int moved = nodes[x].child[side ^ 1];
+    nodes[y].child[side] = moved;
+    if (moved != -1) nodes[moved].parent = y;
+
+    nodes[x].child[side ^ 1] = y;
+    nodes[y].parent = x;
+
+    pull(y);
+    pull(x);
+}
+
+void LinkCutTree::splay(int x) {
+    // Apply pending reversals from the splay root down to x first
+    pathStack.clear();
+    for (int y = x;; y = nodes[y].parent) {
+        pathStack.push_back(y);
+        if (isSplayRoot(y)) break;
+    }
+    for (auto it = pathStack.rbegin(); it != pathStack.rend(); ++it) {
+        push(*it);
+    }
+
+    while (!isSplayRoot(x)) {
+        int y = nodes[x].parent;
+        if (!isSplayRoot(y)) {
+            int z = nodes[y].parent;
+            bool zigZig = (nodes[z].child[0] == y) == (nodes[y].child[0] == x);
+            rotate(zigZig ? y : x);
+        }
+        rotate(x);
+    }
+}
+
+void LinkCutTree::access(int x) {
+    int last = -1;
+    for (int y = x; y != -1; y = nodes[y].parent) {
+        splay(y);
+        nodes[y].child[1] = last;
+        pull(y);
+        last = y;
+    }
+    splay(x);
+}
+
+void LinkCutTree::makeRoot(int x) {
+    access(x);
+    nodes[x].reversed = !nodes[x].reversed;
+}
+
+int LinkCutTree::findRoot(int x) {
+    access(x);
+    while (true) {
+        push(x);
+        if (nodes[x].child[0] == -1) break;
+        x = nodes[x].child[0];
+    }
+    splay(x);
+    return x;
+}
+
+bool LinkCutTree::connected(int x, int y) {
+    if (x == y) return true;
+    return findRoot(x) == findRoot(y);
+}
+
+void LinkCutTree::link(int x, int y) {
+    makeRoot(x);
+    nodes[x].parent = y;
+}
+
+void LinkCutTree::cut(int x, int y) {
+    makeRoot(x);
+    access(y);
+    // The path is exactly x-y, so x is y's whole left subtree
+    nodes[y].child[0] = -1;
+    nodes[x].parent = -1;
+    pull(y);
+}
+
+int LinkCutTree::pathMax(int x, int y) {
+    makeRoot(x);
+    access(y);
+    return nodes[y].maxNode;
+}
@@ -0,0 +1,52 @@
+#ifndef LINK_CUT_TREE_HPP
+#define LINK_CUT_TREE_HPP
+
+#include <vector>
+
+// Link-cut tree (Sleator-Tarjan) over nodes 0..n-1, each carrying an int
+// value. Maintains a forest under link/cut and answers connectivity and
+// path-maximum queries in amortised O(log n). Preferred paths are kept in
+// splay trees; every node also tracks the node with the largest value in
+// its splay subtree.
+class LinkCutTree {
+public:
+    explicit LinkCutTree(int n);
+
+    // Value of a node; only change it while the node is isolated
+    int value(int x) const { return nodes[x].value; }
+    void setValue(int x, int value);
+
+    bool connected(int x, int y);
+
+    // Join the trees of x and y with edge x-y (they must not be connected)
+    void link(int x, int y);
+
+    // Remove the tree edge x-y (it must exist)
+    void cut(int x, int y);
+
+    // Node with the largest value on the tree path x..y (x and y connected)
+    int pathMax(int x, int y);
+
+private:
+    struct Node {
+        int child[2];
+        int parent;
+        int value;
+        int maxNode; // Node with the largest value in this splay subtree
+        bool reversed;
+    };
+
+    bool isSplayRoot(int x) const;
+    void pull(int x);
+    void push(int x);
+    void rotate(int x);
+    void splay(int x);
+    void access(int x);
+    void makeRoot(int x);
+    int findRoot(int x);
+
+    std::vector<Node> nodes;
+    std::vector<int> pathStack; // Scratch for pushing reversals down in splay
+};
+
+#endif // LINK_CUT_TREE_HPP
@@ -0,0 +1,203 @@
+// loadgen.cpp
+//
+// Closed-loop load generator for the text protocol, to compare the servers
+// (mst_solver on 12346, leaderFollower on 8080) under the same workload.
+//
+//   loadgen [-p port] [-c clients] [-n requests] [-v vertices] [-s solve-every] [-a algo]
+//
+// Every client connects, creates a graph with a spanning path (so it is
+// connected) and then sends n requests, waiting for each reply: random
+// "add v w weight" commands with a "solve algo" every s-th request.
+// Prints throughput and latency percentiles over all requests.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int port = 12346;
+    int clients = 8;
+    int requests = 2000;
+    int vertices = 100;
+    int solveEvery = 10;
+    std::string algorithm = "kruskal";
+};
+
+class Client {
+public:
+    explicit Client(int port) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+            throw std::runtime_error(std::string("connect failed: ") + std::strerror(errno));
+        }
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    }
+
+    ~Client() { close(fd); }
+
+    // Send one command and read its reply: one line, or for solve the whole
+    // report up to its last line
+    void request(const std::string& command, bool multiLine) {
+        std::string line = command + "\n";
+        for (size_t sent = 0; sent < line.size();) {
+            ssize_t n = ::send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) throw std::runtime_error("send failed");
+            sent += n;
+        }
+
+        while (true) {
+            std::string reply = readLine();
+            if (!multiLine || reply.rfind("Average distance", 0) == 0 || reply.rfind("No valid MST", 0) == 0 ||
+                reply.rfind("Invalid", 0) == 0) {
+                return;
+            }
+        }
+    }
+
+private:
+    std::string readLine() {
+        while (true) {
+            size_t end = buffer.find('\n', pos);
+            if (end != std::string::npos) {
+                std::string line = buffer.substr(pos, end - pos);
+                pos = end + 1;
+                if (pos == buffer.size()) {
+                    buffer.clear();
+                    pos = 0;
+                }
+                return line;
+            }
+            char chunk[64 * 1024];
+            ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n <= 0) throw std::runtime_error("connection closed by server");
+            buffer.append(chunk, n);
+        }
+    }
+
+    int fd;
+    std::string buffer;
+    size_t pos = 0;
+};
+
+struct ClientResult {
+    std::vector<double> latencies; // Microseconds per request
+    std::chrono::steady_clock::time_point start, end; // Measured phase only
+};
+
+ClientResult runClient(const Options& options, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> vertex(0, options.vertices - 1);
+    std::uniform_int_distribution<int> weight(1, 1000);
+
+    Client client(options.port);
+    client.request("create " + std::to_string(options.vertices) + " 0", false);
+    for (int v = 1; v < options.vertices; ++v) {
+        client.request("add " + std::to_string(v - 1) + " " + std::to_string(v) + " " + std::to_string(weight(rng)), false);
+    }
+
+    ClientResult result;
+    result.latencies.reserve(options.requests);
+    result.start = std::chrono::steady_clock::now();
+    for (int i = 1; i <= options.requests; ++i) {
+        bool solve = options.solveEvery > 0 && i % options.solveEvery == 0;
+        std::string command = solve ? "solve " + options.algorithm
+                                    : "add " + std::to_string(vertex(rng)) + " " + std::to_string(vertex(rng)) + " " +
+                                          std::to_string(weight(rng));
+
+        auto start = std::chrono::steady_clock::now();
+        client.request(command, solve);
+        auto end = std::chrono::steady_clock::now();
+        result.latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    result.end = std::chrono::steady_clock::now();
+    return result;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        std::string value = argv[i + 1];
+        if (flag == "-p") options.port = std::stoi(value);
+        else if (flag == "-c") options.clients = std::stoi(value);
+        else if (flag == "-n") options.requests = std::stoi(value);
+        else if (flag == "-v") options.vertices = std::stoi(value);
+        else if (flag == "-s") options.solveEvery = std::stoi(value);
+        else if (flag == "-a") options.algorithm = value;
+        else {
+            std::fprintf(stderr, "Usage: %s [-p port] [-c clients] [-n requests] [-v vertices] [-s solve-every] [-a algo]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.clients < 1 || options.vertices < 2) {
+        std::fprintf(stderr, "need at least 1 client and 2 vertices\n");
+        return 1;
+    }
+
+    std::vector<ClientResult> results(options.clients);
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed{false};
+    for (int c = 0; c < options.clients; ++c) {
+        threads.emplace_back([&, c]() {
+            try {
+                results[c] = runClient(options, 1234 + c);
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "client %d: %s\n", c, e.what());
+                failed = true;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Wall time of the measured phases, without connecting and graph setup
+    std::vector<double> all;
+    auto start = std::chrono::steady_clock::time_point::max();
+    auto end = std::chrono::steady_clock::time_point::min();
+    for (const ClientResult& result : results) {
+        if (result.latencies.empty()) continue;
+        all.insert(all.end(), result.latencies.begin(), result.latencies.end());
+        start = std::min(start, result.start);
+        end = std::max(end, result.end);
+    }
+    double seconds = all.empty() ? 0.0 : std::chrono::duration<double>(end - start).count();
+    std::sort(all.begin(), all.end());
+
+    std::printf("port %d, %d clients x %d requests (solve every %d, %s, %d vertices)\n", options.port,
+                options.clients, options.requests, options.solveEvery, options.algorithm.c_str(), options.vertices);
+    std::printf("requests %zu, seconds %.3f, throughput %.0f req/s\n", all.size(), seconds,
+                seconds > 0 ? all.size() / seconds : 0.0);
+    std::printf("latency us: p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n", percentile(all, 50), percentile(all, 90),
+                percentile(all, 99), all.empty() ? 0.0 : all.back());
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+#include "logger.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info:  return "INFO";
+        case LogLevel::Warn:  return "WARN";
+        case LogLevel::Error: return "ERROR";
+        default:              return "OFF";
+    }
+}
+
+// Runtime threshold from the LOG_LEVEL environment variable (default: info)
+LogLevel levelFromEnvironment() {
+    const char* value = std::getenv("LOG_LEVEL");
+    if (!value) return LogLevel::Info;
+    if (std::strcmp(value, "debug") == 0) return LogLevel::Debug;
+    if (std::strcmp(value, "warn") == 0) return LogLevel::Warn;
+    if (std::strcmp(value, "error") == 0) return LogLevel::Error;
+    if (std::strcmp(value, "off") == 0) return LogLevel::Off;
+    return LogLevel::Info;
+}
+
+void appendTimestamp(std::string& out, std::chrono::system_clock::time_point time) {
+    std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    int millis = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        time.time_since_epoch()).count() % 1000);
+    std::tm local;
+    localtime_r(&seconds, &local);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d.%03d",
+                  local.tm_hour, local.tm_min, local.tm_sec, millis);
+    out += buffer;
+}
+
+} // namespace
+
+Logger& Logger::instance() {
+    static Logger* logger = new Logger();
+    return *logger;
+}
+
+Logger::Logger()
+    : ring(new Slot[CAPACITY]), enqueuePos(0), dequeuePos(0), written(0), dropped(0),
+      minLevel(levelFromEnvironment()), writerIdle(false) {
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer = std::thread(&Logger::writerLoop, this);
+    writer.detach();
+    std::atexit(&Logger::flushAtExit);
+}
+
+void Logger::log(LogLevel level, std::string message) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &ring[pos & (CAPACITY - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed); // Ring full
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->record.level = level;
+    slot->record.time = std::chrono::system_clock::now();
+    slot->record.text = std::move(message);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    if (writerIdle.load(std::memory_order_relaxed)) {
+        wakeup.notify_one();
+    }
+}
+
+bool Logger::tryPop(Record& record) {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Slot* slot = &ring[pos & (CAPACITY - 1)];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence != pos + 1) return false; // Empty, or the producer is still writing
+
+    // Single consumer: only the writer thread advances dequeuePos
+    dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    record = std::move(slot->record);
+    slot->sequence.store(pos + CAPACITY, std::memory_order_release);
+    return true;
+}
+
+void Logger::writerLoop() {
+    std::string out, err;
+    Record record;
+    uint64_t reportedDrops = 0;
+
+    while (true) {
+        uint64_t count = 0;
+        while (tryPop(record)) {
+            std::string& target = record.level >= LogLevel::Warn ? err : out;
+            target += '[';
+            appendTimestamp(target, record.time);
+            target += "] [";
+            target += levelName(record.level);
+            target += "] ";
+            target += record.text;
+            target += '\n';
+            ++count;
+        }
+
+        uint64_t drops = dropped.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            err += "[logger] " + std::to_string(drops - reportedDrops) + " messages dropped (buffer full)\n";
+            reportedDrops = drops;
+        }
+
+        if (!out.empty()) {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            std::fflush(stdout);
+            out.clear();
+        }
+        if (!err.empty()) {
+            std::fwrite(err.data(), 1, err.size(), stderr);
+            std::fflush(stderr);
+            err.clear();
+        }
+
+        if (count > 0) {
+            written.fetch_add(count, std::memory_order_release);
+            continue;
+        }
+
+        // Nothing queued: sleep until a producer notices and wakes us. The
+        // timeout bounds the delay if a wakeup races with going idle.
+        std::unique_lock<std::mutex> lock(idleMutex);
+        writerIdle.store(true, std::memory_order_relaxed);
+        wakeup.wait_for(lock, std::chrono::milliseconds(20));
+        writerIdle.store(false, std::memory_order_relaxed);
+    }
+}
+
+void Logger::flush() {
+    uint64_t target = enqueuePos.load(std::memory_order_acquire);
+    wakeup.notify_one();
+    while (written.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+void Logger::flushAtExit() {
+    instance().flush();
+}
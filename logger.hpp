@@ -0,0 +1,113 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+enum class LogLevel {
+    Debug = 0,
+    Info = 1,
+    Warn = 2,
+    Error = 3,
+    Off = 4
+};
+
+// Messages below this level are compiled out entirely by the LOG_* macros.
+// Override with -DLOG_COMPILE_LEVEL=<n>; release builds (NDEBUG) drop Debug.
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL 1
+#else
+#define LOG_COMPILE_LEVEL 0
+#endif
+#endif
+
+// Asynchronous logger: producers format a message and push it into a bounded
+// lock-free ring (Vyukov MPMC queue); a background thread drains the ring and
+// writes batches to stdout/stderr, flushing once per batch instead of per line.
+// When the ring is full new messages are dropped and counted rather than
+// blocking the caller.
+class Logger {
+public:
+    static Logger& instance();
+
+    void setLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+
+    // Queue a message for the writer thread (never blocks)
+    void log(LogLevel level, std::string message);
+
+    // Block until everything queued so far has been written
+    void flush();
+
+private:
+    Logger();
+    ~Logger() = default; // Never runs: the instance is leaked so late log calls stay valid during exit
+
+    struct Record {
+        LogLevel level;
+        std::chrono::system_clock::time_point time;
+        std::string text;
+    };
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    static const size_t CAPACITY = 8192; // Power of two
+
+    bool tryPop(Record& record);
+    void writerLoop();
+    static void flushAtExit();
+
+    std::unique_ptr<Slot[]> ring;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+    alignas(64) std::atomic<uint64_t> written;
+    std::atomic<uint64_t> dropped;
+    std::atomic<LogLevel> minLevel;
+
+    std::atomic<bool> writerIdle;
+    std::mutex idleMutex;
+    std::condition_variable wakeup;
+    std::thread writer;
+};
+
+#define LOG_AT(level, expr)                                   \
+    do {                                                      \
+        if (Logger::instance().enabled(level)) {              \
+            std::ostringstream logStream_;                    \
+            logStream_ << expr;                               \
+            Logger::instance().log(level, logStream_.str());  \
+        }                                                     \
+    } while (0)
+
+#if LOG_COMPILE_LEVEL <= 0
+#define LOG_DEBUG(expr) LOG_AT(LogLevel::Debug, expr)
+#else
+#define LOG_DEBUG(expr) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 1
+#define LOG_INFO(expr) LOG_AT(LogLevel::Info, expr)
+#else
+#define LOG_INFO(expr) do {} while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 2
+#define LOG_WARN(expr) LOG_AT(LogLevel::Warn, expr)
+#else
+#define LOG_WARN(expr) do {} while (0)
+#endif
+
+#define LOG_ERROR(expr) LOG_AT(LogLevel::Error, expr)
+
+#endif // LOGGER_HPP
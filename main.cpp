@@ -1,24 +1,73 @@
 #include "server.hpp"
 #include <csignal>
-#include <iostream>
+#include "logger.hpp"
+#include <string>
+#include <utility>
 
 // Server instance to use in signal handler
 server* globalServerInstance = nullptr;
 
 // Signal handler function to handle Ctrl+C
 void signalHandler(int signum) {
-    std::cout << "\nInterrupt signal (" << signum << ") received. Shutting down server..." << std::endl;
+    LOG_INFO("Interrupt signal (" << signum << ") received. Shutting down server...");
     if (globalServerInstance) {
         globalServerInstance->stop(); // Assuming you have a stop method in your server
     }
     exit(signum);
 }
 
-int main() {
+// Apply "[stage=]N" to the replica count or queue capacity of one stage,
+// or of every stage when no name is given
+void applyStageOption(PipelineConfig& config, bool replicas, const std::string& value) {
+    size_t equals = value.find('=');
+    std::string stage = equals == std::string::npos ? "" : value.substr(0, equals);
+    size_t number = std::stoul(value.substr(equals == std::string::npos ? 0 : equals + 1));
+
+    const std::pair<const char*, std::pair<size_t*, size_t*>> stages[] = {
+        {"commandProcessing", {&config.commandProcessingReplicas, &config.commandProcessingCapacity}},
+        {"graphUpdate", {&config.graphUpdateReplicas, &config.graphUpdateCapacity}},
+        {"mstComputation", {&config.mstComputationReplicas, &config.mstComputationCapacity}},
+        {"response", {&config.responseReplicas, &config.responseCapacity}},
+    };
+    bool matched = false;
+    for (const auto& entry : stages) {
+        if (stage.empty() || stage == entry.first) {
+            *(replicas ? entry.second.first : entry.second.second) = number;
+            matched = true;
+        }
+    }
+    if (!matched) {
+        LOG_WARN("Unknown pipeline stage: " << stage);
+    }
+}
+
+int main(int argc, char* argv[]) {
     // Register signal handler
     signal(SIGINT, signalHandler);
 
-    server srv(12346);
+    // Optional: --io epoll|uring selects the I/O backend;
+    // --replicas [stage=]N and --queue-capacity [stage=]N size one pipeline
+    // stage, or all of them without a stage name; --output-limit BYTES caps
+    // the replies queued per connection before its reading pauses;
+    // --huge-pages backs large session allocations with transparent huge pages
+    std::string ioBackend = "epoll";
+    PipelineConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--huge-pages") {
+            config.hugePages = true;
+        } else if (i + 1 == argc) {
+            break;
+        } else if (arg == "--io") {
+            ioBackend = argv[++i];
+        } else if (arg == "--replicas" || arg == "--queue-capacity") {
+            applyStageOption(config, arg == "--replicas", argv[++i]);
+        } else if (arg == "--output-limit") {
+            config.connectionOutputLimit = std::stoul(argv[++i]);
+        }
+    }
+
+    server srv(12346, ioBackend, config);
     globalServerInstance = &srv;
     srv.start();
 
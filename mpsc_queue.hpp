@@ -0,0 +1,69 @@
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <atomic>
+
+// Intrusive lock-free multi-producer single-consumer queue after Dmitry
+// Vyukov's design with a stub node. Node must be default-constructible and
+// have a `std::atomic<Node*> next` member; the queue links nodes through it
+// and never allocates. push is wait-free: one atomic exchange. pop is for
+// the single consumer only and may return nullptr while a producer is
+// between its exchange and its link store; hasPending() then still reports
+// the node on its way.
+template <typename Node>
+class MPSCQueue {
+public:
+    MPSCQueue() : head(&stub), tail(&stub) { stub.next.store(nullptr, std::memory_order_relaxed); }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // Any thread. Sequentially consistent, so a consumer that announced it
+    // is going to sleep and then checks hasPending() cannot miss the node.
+    void push(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* prev = head.exchange(node, std::memory_order_seq_cst);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer only; the returned node belongs to the caller again
+    Node* pop() {
+        Node* first = tail;
+        Node* next = first->next.load(std::memory_order_acquire);
+        if (first == &stub) {
+            if (next == nullptr) return nullptr;
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+
+        // first is the last linked node: a producer is mid-push behind it
+        if (first != head.load(std::memory_order_acquire)) return nullptr;
+
+        // Put the stub behind first so first can be handed out
+        push(&stub);
+        next = first->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+        return nullptr;
+    }
+
+    // Consumer only, after pop returned nullptr: true if a node was pushed
+    // since (or is still being linked), so the consumer must not sleep
+    bool hasPending() const {
+        return head.load(std::memory_order_seq_cst) != tail || tail->next.load(std::memory_order_acquire) != nullptr;
+    }
+
+private:
+    alignas(64) std::atomic<Node*> head; // Producers: last pushed node
+    alignas(64) Node* tail;              // Consumer: next node to pop
+    Node stub;
+};
+
+#endif // MPSC_QUEUE_HPP
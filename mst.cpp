@@ -1,4 +1,6 @@
 #include "mst.hpp"
+#include "logger.hpp"
+#include <sstream>
 
 MST::MST(int V) : V(V), totalWeight(0) {}
 
@@ -16,9 +18,11 @@ const std::vector<Edge>& MST::getTreeEdges() const {
 }
 
 void MST::printMST() const {
-    std::cout << "Minimum Spanning Tree:" << std::endl;
+    std::ostringstream oss;
+    oss << "Minimum Spanning Tree:";
     for (const Edge& edge : mstEdges) {
-        std::cout << edge.v << " --(" << edge.weight << ")--> " << edge.w << std::endl;
+        oss << "\n" << edge.v << " --(" << edge.weight << ")--> " << edge.w;
     }
-    std::cout << "Total weight of the MST: " << totalWeight << std::endl;
+    oss << "\nTotal weight of the MST: " << totalWeight;
+    LOG_INFO(oss.str());
 }
@@ -4,7 +4,7 @@
 #include "pipelineStage.hpp"
 #include "pipelineData.hpp"
 #include "mst_factory.hpp"
-#include <iostream>
+#include "logger.hpp"
 #include <memory> 
 
 class mstComputationStage : public pipelineStage {
@@ -13,19 +13,21 @@ public:
         if (!data) return;
 
         // Determine the algorithm to use and create the solver
-        std::unique_ptr<MSTSolver> solver = MSTFactory::createSolver(data->algorithm == "prim" ? PRIM : KRUSKAL);
+        std::unique_ptr<MSTSolver> solver = MSTFactory::createSolver(MSTFactory::algorithmFromName(data->algorithm));
         if (solver) {
-            // Compute the MST
-            auto mstEdges = solver->solveMST(data->graph);
+            // Compute the MST on the latest published version of the graph
+            std::shared_ptr<GraphSnapshot> snapshot = data->graph->snapshot();
+            std::lock_guard<std::mutex> lock(snapshot->solveMutex);
+            auto mstEdges = solver->solveMST(snapshot->graph);
             
             // Generate the MST result string
-            data->response = solver->getMSTResults(data->graph, mstEdges);
+            data->response = solver->getMSTResults(snapshot->graph, mstEdges);
 
             // Debug output
-            std::cout << "Debug: MST computed using " << data->algorithm << " algorithm." << std::endl;
+            LOG_DEBUG("MST computed using " << data->algorithm << " algorithm.");
         } else {
             data->response = "Invalid algorithm specified.";
-            std::cerr << "Error: Invalid algorithm specified for MST computation." << std::endl;
+            LOG_ERROR("Invalid algorithm specified for MST computation.");
         }
 
         // Enqueue the response stage to send results to the client
@@ -0,0 +1,337 @@
+// mst_bench.cpp
+//
+// Solver and statistics benchmark over generated graphs, for comparing
+// builds (run by "make bench").
+//
+//   mst_bench [-e edges,...] [-g generator,...] [-r reps] [-p max-prim-vertices]
+//
+// For every generator and target edge count it builds one graph from a fixed
+// seed, then times each MSTFactory algorithm (solveMST, so the incremental
+// MST cache is not involved) and each Graph statistic over the Kruskal tree.
+// Every case runs in a forked child: one untimed warm-up (which also builds
+// the lazily derived CSR), then reps timed runs. The child's peak RSS comes
+// from wait4, so it covers that case only (plus the graph it inherits);
+// graph_rss_kb is the parent's resident size after generating the graph.
+//
+// Generators (each sized to roughly the target edge count):
+//   sparse        random spanning tree plus random edges, average degree 8
+//   dense         complete graph
+//   grid          square 4-neighbour grid
+//   powerlaw      preferential attachment, 4 edges per new vertex
+//   disconnected  four sparse components; edge-based solvers find no MST
+//
+// Prim's O(V^2) array solver is skipped above max-prim-vertices (20000).
+// Output is CSV on stdout, one row per case, times in milliseconds:
+//   generator,vertices,edges,case,reps,median_ms,p90_ms,p99_ms,min_ms,max_ms,graph_rss_kb,peak_rss_kb
+// p90_ms needs at least 10 reps and p99_ms at least 100; with fewer they
+// would only repeat max_ms, so the field is left empty.
+
+#include "graph.hpp"
+#include "logger.hpp"
+#include "mst_factory.hpp"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<long> edges = {10000, 100000, 1000000};
+    std::vector<std::string> generators = {"sparse", "dense", "grid", "powerlaw", "disconnected"};
+    int reps = 10;
+    int maxPrimVertices = 20000;
+};
+
+const int MAX_WEIGHT = 1000000;
+
+struct Algorithm {
+    const char* name;
+    MSTAlgorithmType type;
+};
+
+const Algorithm ALGORITHMS[] = {
+    {"prim", PRIM},
+    {"kruskal", KRUSKAL},
+    {"primheap", PRIM_HEAP},
+    {"boruvka", BORUVKA},
+    {"filterkruskal", FILTER_KRUSKAL},
+};
+
+// Random edges between uniformly chosen vertices of [first, first + count)
+void addRandomEdges(Graph& graph, int first, int count, long edges, std::mt19937& rng) {
+    std::uniform_int_distribution<int> vertex(first, first + count - 1);
+    std::uniform_int_distribution<int> weight(1, MAX_WEIGHT);
+    for (long i = 0; i < edges; ++i) {
+        int v = vertex(rng);
+        int w = vertex(rng);
+        graph.addEdge(v, w, weight(rng));
+    }
+}
+
+// Random recursive tree over [first, first + count), so the range is connected
+void addRandomTree(Graph& graph, int first, int count, std::mt19937& rng) {
+    std::uniform_int_distribution<int> weight(1, MAX_WEIGHT);
+    for (int i = 1; i < count; ++i) {
+        graph.addEdge(first + static_cast<int>(rng() % i), first + i, weight(rng));
+    }
+}
+
+Graph sparseGraph(long edges, std::mt19937& rng) {
+    int V = static_cast<int>(std::max(2L, edges / 4));
+    Graph graph(V);
+    graph.reserveEdges(edges);
+    addRandomTree(graph, 0, V, rng);
+    addRandomEdges(graph, 0, V, std::max(0L, edges - (V - 1)), rng);
+    return graph;
+}
+
+Graph denseGraph(long edges, std::mt19937& rng) {
+    int V = std::max(2, static_cast<int>(std::lround((1 + std::sqrt(1 + 8.0 * edges)) / 2)));
+    Graph graph(V);
+    graph.reserveEdges(static_cast<size_t>(V) * (V - 1) / 2);
+    std::uniform_int_distribution<int> weight(1, MAX_WEIGHT);
+    for (int v = 0; v < V; ++v) {
+        for (int w = v + 1; w < V; ++w) {
+            graph.addEdge(v, w, weight(rng));
+        }
+    }
+    return graph;
+}
+
+Graph gridGraph(long edges, std::mt19937& rng) {
+    int side = std::max(2, static_cast<int>(std::lround(std::sqrt(edges / 2.0))));
+    Graph graph(side * side);
+    graph.reserveEdges(2 * static_cast<size_t>(side) * (side - 1));
+    std::uniform_int_distribution<int> weight(1, MAX_WEIGHT);
+    for (int row = 0; row < side; ++row) {
+        for (int col = 0; col < side; ++col) {
+            int v = row * side + col;
+            if (col + 1 < side) graph.addEdge(v, v + 1, weight(rng));
+            if (row + 1 < side) graph.addEdge(v, v + side, weight(rng));
+        }
+    }
+    return graph;
+}
+
+// Barabasi-Albert: each new vertex links to LINKS earlier ones chosen in
+// proportion to their degree (uniform pick over all edge endpoints so far)
+Graph powerLawGraph(long edges, std::mt19937& rng) {
+    const int LINKS = 4;
+    int V = static_cast<int>(std::max<long>(LINKS + 1, edges / LINKS));
+    Graph graph(V);
+    graph.reserveEdges(static_cast<size_t>(V) * LINKS);
+    std::uniform_int_distribution<int> weight(1, MAX_WEIGHT);
+    std::vector<int> endpoints;
+    endpoints.reserve(2 * static_cast<size_t>(V) * LINKS);
+    for (int v = 1; v <= LINKS; ++v) {
+        graph.addEdge(0, v, weight(rng));
+        endpoints.push_back(0);
+        endpoints.push_back(v);
+    }
+    for (int v = LINKS + 1; v < V; ++v) {
+        for (int link = 0; link < LINKS; ++link) {
+            int w = endpoints[rng() % endpoints.size()];
+            graph.addEdge(v, w, weight(rng));
+            endpoints.push_back(v);
+            endpoints.push_back(w);
+        }
+    }
+    return graph;
+}
+
+Graph disconnectedGraph(long edges, std::mt19937& rng) {
+    const int COMPONENTS = 4;
+    int perComponent = static_cast<int>(std::max(2L, edges / 4 / COMPONENTS));
+    Graph graph(perComponent * COMPONENTS);
+    graph.reserveEdges(edges);
+    for (int c = 0; c < COMPONENTS; ++c) {
+        addRandomTree(graph, c * perComponent, perComponent, rng);
+        addRandomEdges(graph, c * perComponent, perComponent,
+                       std::max(0L, edges / COMPONENTS - (perComponent - 1)), rng);
+    }
+    return graph;
+}
+
+bool generate(const std::string& name, long edges, Graph& graph) {
+    // One seed per generator and size, so every build sees the same graphs
+    std::mt19937 rng(static_cast<unsigned>(std::hash<std::string>()(name) ^ static_cast<size_t>(edges)));
+    if (name == "sparse") graph = sparseGraph(edges, rng);
+    else if (name == "dense") graph = denseGraph(edges, rng);
+    else if (name == "grid") graph = gridGraph(edges, rng);
+    else if (name == "powerlaw") graph = powerLawGraph(edges, rng);
+    else if (name == "disconnected") graph = disconnectedGraph(edges, rng);
+    else return false;
+    return true;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Percentile p as a CSV field; empty with fewer than 100 / (100 - p) samples
+std::string percentileField(const std::vector<double>& sorted, double p) {
+    if (sorted.size() * (100 - p) < 100) return "";
+    char field[32];
+    std::snprintf(field, sizeof(field), "%.3f", percentile(sorted, p));
+    return field;
+}
+
+long currentRssKb() {
+    long pages = 0, resident = 0;
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm) {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+        std::fclose(statm);
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Time run() reps times in a child process (after one warm-up run). The
+// child writes its timings to a pipe; false if it failed.
+bool runCase(const std::function<void()>& run, int reps, std::vector<double>& millis, long& peakRssKb) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    std::fflush(stdout);
+    std::fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        run();
+        std::vector<double> times;
+        for (int i = 0; i < reps; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        size_t bytes = times.size() * sizeof(double);
+        bool ok = write(fds[1], times.data(), bytes) == static_cast<ssize_t>(bytes);
+        _exit(ok ? 0 : 1);
+    }
+
+    close(fds[1]);
+    millis.assign(reps, 0.0);
+    size_t wanted = reps * sizeof(double), got = 0;
+    char* out = reinterpret_cast<char*>(millis.data());
+    while (got < wanted) {
+        ssize_t n = read(fds[0], out + got, wanted - got);
+        if (n <= 0) break;
+        got += n;
+    }
+    close(fds[0]);
+
+    int status = 0;
+    struct rusage usage {};
+    wait4(pid, &status, 0, &usage);
+    peakRssKb = usage.ru_maxrss; // Kilobytes on Linux
+    return got == wanted && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+void report(const std::string& generator, const Graph& graph, const std::string& name, const std::function<void()>& run,
+            const Options& options, long graphRssKb) {
+    std::vector<double> millis;
+    long peakRssKb = 0;
+    if (!runCase(run, options.reps, millis, peakRssKb)) {
+        std::fprintf(stderr, "%s/%s: benchmark child failed\n", generator.c_str(), name.c_str());
+        return;
+    }
+    std::sort(millis.begin(), millis.end());
+    std::printf("%s,%d,%zu,%s,%d,%.3f,%s,%s,%.3f,%.3f,%ld,%ld\n", generator.c_str(), graph.getV(),
+                graph.getEdges().size(), name.c_str(), options.reps, percentile(millis, 50),
+                percentileField(millis, 90).c_str(), percentileField(millis, 99).c_str(), millis.front(), millis.back(),
+                graphRssKb, peakRssKb);
+}
+
+void benchGraph(const std::string& generator, Graph& graph, const Options& options) {
+    long graphRssKb = currentRssKb();
+
+    for (const Algorithm& algorithm : ALGORITHMS) {
+        if (algorithm.type == PRIM && graph.getV() > options.maxPrimVertices) continue;
+        report(generator, graph, algorithm.name, [&graph, &algorithm]() {
+            auto solver = MSTFactory::createSolver(algorithm.type);
+            volatile size_t sink = solver->solveMST(graph).size();
+            (void)sink;
+        }, options, graphRssKb);
+    }
+
+    // Statistics run over the Kruskal tree, which is empty for a
+    // disconnected graph; solved once here so the children inherit it
+    std::vector<Edge> treeEdges = MSTFactory::createSolver(KRUSKAL)->solveMST(graph);
+    EdgeArrays tree(treeEdges);
+    const std::pair<const char*, std::function<void()>> statistics[] = {
+        {"total_weight", [&]() { volatile long long sink = graph.calculateTotalWeight(tree); (void)sink; }},
+        {"longest_distance", [&]() { volatile int sink = graph.findLongestDistance(tree); (void)sink; }},
+        {"shortest_distance", [&]() { volatile int sink = graph.findShortestDistance(tree); (void)sink; }},
+        {"average_distance", [&]() { volatile double sink = graph.calculateAverageDistance(tree); (void)sink; }},
+        {"all_statistics", [&]() { volatile long long sink = MSTSolver::computeStatistics(graph, treeEdges).totalWeight; (void)sink; }},
+    };
+    for (const auto& [name, run] : statistics) {
+        report(generator, graph, name, run, options, graphRssKb);
+    }
+}
+
+template <typename T, typename Parse>
+std::vector<T> splitList(const std::string& value, Parse parse) {
+    std::vector<T> items;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(parse(item));
+    }
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        std::string value = argv[i + 1];
+        if (flag == "-e") options.edges = splitList<long>(value, [](const std::string& s) { return std::stol(s); });
+        else if (flag == "-g") options.generators = splitList<std::string>(value, [](const std::string& s) { return s; });
+        else if (flag == "-r") options.reps = std::stoi(value);
+        else if (flag == "-p") options.maxPrimVertices = std::stoi(value);
+        else {
+            std::fprintf(stderr, "Usage: %s [-e edges,...] [-g generator,...] [-r reps] [-p max-prim-vertices]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.reps < 1 || options.edges.empty() || options.generators.empty()) {
+        std::fprintf(stderr, "need at least 1 rep, edge count and generator\n");
+        return 1;
+    }
+
+    // Disconnected graphs make the solvers log at info level on every run
+    Logger::instance().setLevel(LogLevel::Error);
+
+    std::printf("generator,vertices,edges,case,reps,median_ms,p90_ms,p99_ms,min_ms,max_ms,graph_rss_kb,peak_rss_kb\n");
+    for (const std::string& generator : options.generators) {
+        for (long edges : options.edges) {
+            Graph graph(0);
+            if (!generate(generator, edges, graph)) {
+                std::fprintf(stderr, "unknown generator: %s\n", generator.c_str());
+                return 1;
+            }
+            std::fprintf(stderr, "%s: %d vertices, %zu edges\n", generator.c_str(), graph.getV(), graph.getEdges().size());
+            benchGraph(generator, graph, options);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "mst_cache.hpp"
+#include "logger.hpp"
+#include <algorithm>
+
+std::atomic<uint64_t> MSTResultCache::hitCount{0};
+std::atomic<uint64_t> MSTResultCache::missCount{0};
+
+const MSTResult& MSTResultCache::get(Graph& graph, MSTSolver& solver) {
+    bool spanning = result.edges.size() == static_cast<size_t>(std::max(graph.getV() - 1, 0));
+    if (valid && version == graph.getVersion() && (spanning || solverType == typeid(solver))) {
+        hitCount.fetch_add(1, std::memory_order_relaxed);
+        LOG_DEBUG("MST cache hit for graph version " << version);
+        return result;
+    }
+
+    missCount.fetch_add(1, std::memory_order_relaxed);
+    result.edges = solver.solve(graph);
+    result.stats = MSTSolver::computeStatistics(graph, result.edges);
+    responses.clear();
+    version = graph.getVersion();
+    solverType = typeid(solver);
+    valid = true;
+    return result;
+}
+
+const std::string& MSTResultCache::response(const std::string& key,
+                                            const std::function<std::string(const MSTResult&)>& format) {
+    auto it = responses.find(key);
+    if (it == responses.end()) {
+        it = responses.emplace(key, format(result)).first;
+    }
+    return it->second;
+}
@@ -0,0 +1,51 @@
+#ifndef MST_CACHE_HPP
+#define MST_CACHE_HPP
+
+#include "graph.hpp"
+#include "mst_solver.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+// MST of a graph together with its statistics
+struct MSTResult {
+    std::vector<Edge> edges;
+    MSTStatistics stats;
+};
+
+// Last MST result of one session's graph, keyed by Graph::getVersion().
+// A solve on an unchanged graph reuses the edges, the statistics and any
+// response already serialised for the same format. Every algorithm finds a
+// spanning tree of the same weight, so such a result serves all of them;
+// on a disconnected graph they report different things (no tree, or a
+// partial one), so a result with fewer than V-1 edges is keyed by the
+// solver's type as well.
+// Not thread-safe: a session only solves on the mstComputation stage.
+class MSTResultCache {
+public:
+    // Result for the graph's current version, running solver on a miss
+    const MSTResult& get(Graph& graph, MSTSolver& solver);
+
+    // Serialised form of the current result; format runs once per key
+    const std::string& response(const std::string& key, const std::function<std::string(const MSTResult&)>& format);
+
+    // Process-wide lookup counters
+    static uint64_t hits() { return hitCount.load(std::memory_order_relaxed); }
+    static uint64_t misses() { return missCount.load(std::memory_order_relaxed); }
+
+private:
+    bool valid = false;
+    uint64_t version = 0;
+    std::type_index solverType = typeid(void); // Solver that produced result
+    MSTResult result;
+    std::unordered_map<std::string, std::string> responses;
+
+    static std::atomic<uint64_t> hitCount;
+    static std::atomic<uint64_t> missCount;
+};
+
+#endif // MST_CACHE_HPP
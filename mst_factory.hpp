@@ -4,22 +4,45 @@
 #include "mst_solver.hpp"
 #include "prim_mst_solver.hpp"
 #include "kruskal_mst_solver.hpp"
+#include "heap_prim_mst_solver.hpp"
+#include "boruvka_mst_solver.hpp"
+#include "filter_kruskal_mst_solver.hpp"
 #include <memory>
+#include <string>
 
 enum MSTAlgorithmType {
     PRIM,
-    KRUSKAL
+    KRUSKAL,
+    PRIM_HEAP,
+    BORUVKA,
+    FILTER_KRUSKAL
 };
 
 class MSTFactory {
 public:
-    static std::unique_ptr<MSTSolver> createSolver(MSTAlgorithmType type) {
+    // numThreads only applies to parallel solvers; 0 means one per hardware thread
+    static std::unique_ptr<MSTSolver> createSolver(MSTAlgorithmType type, unsigned numThreads = 0) {
         if (type == PRIM) {
             return std::make_unique<PrimMSTSolver>();
         } else if (type == KRUSKAL) {
             return std::make_unique<KruskalMSTSolver>();
+        } else if (type == PRIM_HEAP) {
+            return std::make_unique<HeapPrimMSTSolver>();
+        } else if (type == BORUVKA) {
+            return std::make_unique<BoruvkaMSTSolver>(numThreads);
+        } else if (type == FILTER_KRUSKAL) {
+            return std::make_unique<FilterKruskalMSTSolver>();
         }
         return nullptr;
     }
+
+    // Map the algorithm name sent by clients to a solver type (Kruskal by default)
+    static MSTAlgorithmType algorithmFromName(const std::string& name) {
+        if (name == "prim") return PRIM;
+        if (name == "primheap") return PRIM_HEAP;
+        if (name == "boruvka") return BORUVKA;
+        if (name == "filterkruskal") return FILTER_KRUSKAL;
+        return KRUSKAL;
+    }
 };
 #endif // MST_FACTORY_HPP
@@ -1,17 +1,46 @@
 #include "mst_solver.hpp"
+#include "kruskal_mst_solver.hpp"
+#include <algorithm>
 #include <sstream>
 
+MSTStatistics MSTSolver::computeStatistics(Graph& graph, const std::vector<Edge>& mstEdges) {
+    // One split into arrays serves all four: the reductions read only the
+    // weights, the tree walks build their CSR from the arrays
+    EdgeArrays tree(mstEdges, graph.resource());
+    MSTStatistics stats;
+    stats.totalWeight = graph.calculateTotalWeight(tree);
+    stats.longestDistance = graph.findLongestDistance(tree);
+    stats.shortestDistance = graph.findShortestDistance(tree);
+    stats.averageDistance = graph.calculateAverageDistance(tree);
+    return stats;
+}
+
+std::vector<Edge> MSTSolver::solve(Graph& graph) {
+    std::vector<Edge> mstEdges;
+    if (graph.maintainedMST(mstEdges)) {
+        return mstEdges;
+    }
+
+    mstEdges = solveMST(graph);
+    if (!graph.hasMaintainedMST()) {
+        // A spanning tree is the graph's minimum spanning forest; a
+        // disconnected graph needs one more Kruskal pass to find its forest
+        bool spanning = mstEdges.size() == static_cast<size_t>(std::max(graph.getV() - 1, 0));
+        graph.seedMST(spanning ? mstEdges : KruskalMSTSolver::spanningForest(graph));
+    }
+    return mstEdges;
+}
+
 std::string MSTSolver::getMSTResults(Graph& graph, const std::vector<Edge>& mstEdges) {
-    int totalWeight = graph.calculateTotalWeight(mstEdges);
-    int longestDistance = graph.findLongestDistance(mstEdges);
-    int shortestDistance = graph.findShortestDistance(mstEdges);
-    double averageDistance = graph.calculateAverageDistance(mstEdges);
+    return formatResults(mstEdges, computeStatistics(graph, mstEdges));
+}
 
+std::string MSTSolver::formatResults(const std::vector<Edge>& mstEdges, const MSTStatistics& stats) {
     std::stringstream ss;
-    ss << "Total weight of the MST: " << totalWeight << "\n";
-    ss << "Longest distance between two vertices: " << longestDistance << "\n";
-    ss << "Shortest distance between two vertices: " << shortestDistance << "\n";
-    ss << "Average distance between two vertices: " << averageDistance << "\n";
+    ss << "Total weight of the MST: " << stats.totalWeight << "\n";
+    ss << "Longest distance between two vertices: " << stats.longestDistance << "\n";
+    ss << "Shortest distance between two vertices: " << stats.shortestDistance << "\n";
+    ss << "Average distance between two vertices: " << stats.averageDistance << "\n";
 
     return ss.str();
 }
@@ -5,11 +5,31 @@
 #include <vector>
 #include <string>
 
+// Summary values reported for every MST
+struct MSTStatistics {
+    long long totalWeight;
+    int longestDistance;
+    int shortestDistance;
+    double averageDistance;
+};
+
 class MSTSolver {
 public:
     virtual ~MSTSolver() = default; 
     virtual std::vector<Edge> solveMST(Graph& graph) = 0; // Pure virtual function
-    virtual std::string getMSTResults(Graph& graph, const std::vector<Edge>& mstEdges); 
+    std::string getMSTResults(Graph& graph, const std::vector<Edge>& mstEdges);
+
+    // Text report for an MST whose statistics are already known
+    virtual std::string formatResults(const std::vector<Edge>& mstEdges, const MSTStatistics& stats);
+
+    // solveMST unless the graph's incrementally maintained minimum spanning
+    // forest already spans it. A graph that lost its forest (bulk loads, removals) is
+    // reseeded here, so later solves after further addEdge calls return
+    // without recomputing once the forest spans the graph.
+    std::vector<Edge> solve(Graph& graph);
+
+    // The statistics behind getMSTResults, for callers that format their own output
+    static MSTStatistics computeStatistics(Graph& graph, const std::vector<Edge>& mstEdges);
 };
 
 #endif // MST_SOLVER_HPP
@@ -1,20 +1,41 @@
 #ifndef PIPELINEDATA_HPP
 #define PIPELINEDATA_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
+#include "arena.hpp"
 #include "graph.hpp"
+#include "graph_registry.hpp"
+#include "connection.hpp"
+
+// Wire protocol of a connection, decided by its first byte
+enum class ProtocolMode {
+    Unknown,
+    Text,
+    Binary
+};
 
 class pipelineData {
 public:
-    // Graph-related members
-    Graph graph;
+    // Graph-related members: the session's private graph, or a named one
+    // from the server's registry after "use"
+    std::shared_ptr<SharedGraph> graph;
+    std::string graphName;
+
+    // Memory for the session's private graphs and their solves; released
+    // once the session and the last snapshot of those graphs are gone
+    std::shared_ptr<SessionArena> arena;
     int edges;
     int vertices;
     int v, w, weight;
     int client_fd;
+    std::shared_ptr<Connection> connection; // Event-loop connection, if any
 
-    pipelineData() : graph(0), v(0), w(0), weight(0), client_fd(-1) {}
+    explicit pipelineData(std::shared_ptr<SessionArena> arena = nullptr)
+        : graph(std::make_shared<SharedGraph>(Graph(0, arena))), arena(arena), v(0), w(0), weight(0), client_fd(-1) {}
 
     // MST computation
     std::string algorithm;
@@ -25,6 +46,37 @@ public:
     // Command type (create, add, etc.)
     std::string command;
 
+    // Text or binary protocol (only touched by the event-loop thread)
+    ProtocolMode protocol = ProtocolMode::Unknown;
+
+    // Edge lines of the current addbatch still to be framed (event-loop thread)
+    size_t batchLinesLeft = 0;
+
+    // Reading paused for room in commandProcessing, counted in the server's
+    // pausedReads (event-loop thread)
+    bool waitingForRoom = false;
+
+    // Progress of the current addbatch (commandProcessing thread)
+    size_t batchPending = 0;
+    size_t batchAdded = 0;
+    size_t batchRejected = 0;
+    uint64_t batchSeq = 0; // Command number of the addbatch, for its reply
+
+    // Reply ordering. commandProcessing numbers the commands in arrival
+    // order; the response stage sends replies in that order and holds back
+    // any that overtook an earlier one (an add finishing while a solve of the
+    // same client is still running on mstComputation). The event loop reads
+    // both counters to tell when a half-closed client has all its replies.
+    std::atomic<uint64_t> nextRequestSeq{0};  // Written by commandProcessing
+    std::atomic<uint64_t> nextResponseSeq{0}; // Written by response
+    std::map<uint64_t, std::string> heldResponses; // response thread
+
+    // commandProcessing tasks queued or running (incremented by the event
+    // loop), and whether the client has sent EOF: from then on the stages
+    // wake the event loop as this session's work completes
+    std::atomic<size_t> commandTasks{0};
+    std::atomic<bool> inputClosed{false};
+
 };
 
 #endif // PIPELINEDATA_HPP
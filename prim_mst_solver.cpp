@@ -1,4 +1,5 @@
 #include "prim_mst_solver.hpp"
+#include <memory_resource>
 #include <vector>
 #include <limits.h>
 #include <iostream>
@@ -6,32 +7,38 @@
 
 std::vector<Edge> PrimMSTSolver::solveMST(Graph& graph) {
     int V = graph.getV();
-    std::vector<int> key(V, INT_MAX);
-    std::vector<int> parent(V, -1);
-    std::vector<bool> inMST(V, false);
+    if (V == 0) return {};
+
+    const CSRGraph& csr = graph.getCSR();
+
+    // Scratch comes from one buffer in the graph's arena, freed in one go
+    std::pmr::monotonic_buffer_resource scratch(V * (2 * sizeof(int) + 1) + 64, graph.resource());
+    std::pmr::vector<int> key(V, INT_MAX, &scratch);
+    std::pmr::vector<int> parent(V, -1, &scratch);
+    std::pmr::vector<bool> inMST(V, false, &scratch);
     std::vector<Edge> mstEdges;
 
     key[0] = 0;
 
     for (int count = 0; count < V - 1; ++count) {
         int u = graph.minKey(key, inMST);
+        if (u == -1) break; // Remaining vertices are unreachable from vertex 0
         inMST[u] = true;
 
-        for (const Edge& edge : graph.getAdj()[u]) {
-            int v = edge.w;
-            if (!inMST[v] && edge.weight < key[v]) {
-                key[v] = edge.weight;
+        for (int i = csr.offsets[u]; i < csr.offsets[u + 1]; ++i) {
+            int v = csr.neighbors[i];
+            if (!inMST[v] && csr.weights[i] < key[v]) {
+                key[v] = csr.weights[i];
                 parent[v] = u;
             }
         }
     }
 
+    // key[i] holds the weight of the lightest edge to parent[i], which also
+    // picks the right one among parallel edges
     for (int i = 1; i < V; ++i) {
-        for (const Edge& edge : graph.getAdj()[i]) {
-            if (edge.w == parent[i]) {
-                mstEdges.push_back(edge);
-                break;
-            }
+        if (parent[i] != -1) {
+            mstEdges.push_back(Edge(i, parent[i], key[i]));
         }
     }
 
@@ -39,7 +46,7 @@ std::vector<Edge> PrimMSTSolver::solveMST(Graph& graph) {
 }
 
 
-std::string PrimMSTSolver::getMSTResults(Graph& graph, const std::vector<Edge>& mstEdges) {
+std::string PrimMSTSolver::formatResults(const std::vector<Edge>& mstEdges, const MSTStatistics& stats) {
     std::ostringstream oss;
 
      oss << "Edges in the constructed MST:\n";
@@ -47,17 +54,11 @@ std::string PrimMSTSolver::getMSTResults(Graph& graph, const std::vector<Edge>&
         oss << edge.v << " - " << edge.w << " == " << edge.weight << "\n";
     }
 
-    // Calculate the desired values
-    int totalWeight = graph.calculateTotalWeight(mstEdges);
-    int longestDistance = graph.findLongestDistance(mstEdges);
-    int shortestDistance = graph.findShortestDistance(mstEdges);
-    double averageDistance = graph.calculateAverageDistance(mstEdges);
-
     // Output the calculated values
-    oss << "Total weight of the MST: " << totalWeight << "\n";
-    oss << "Longest distance between two vertices: " << longestDistance << "\n";
-    oss << "Shortest distance between two vertices: " << shortestDistance << "\n";
-    oss << "Average distance between two vertices: " << averageDistance << "\n";
+    oss << "Total weight of the MST: " << stats.totalWeight << "\n";
+    oss << "Longest distance between two vertices: " << stats.longestDistance << "\n";
+    oss << "Shortest distance between two vertices: " << stats.shortestDistance << "\n";
+    oss << "Average distance between two vertices: " << stats.averageDistance << "\n";
 
     return oss.str();
 }
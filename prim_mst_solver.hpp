@@ -7,7 +7,7 @@
 class PrimMSTSolver : public MSTSolver {
 public:
     std::vector<Edge> solveMST(Graph& graph) override; // Change return type to std::vector<Edge>
-    std::string getMSTResults(Graph& graph, const std::vector<Edge>& mstEdges) override;
+    std::string formatResults(const std::vector<Edge>& mstEdges, const MSTStatistics& stats) override;
 };
 
 #endif // PRIM_MST_SOLVER_HPP
@@ -0,0 +1,244 @@
+#include "reactor.hpp"
+#include "logger.hpp"
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+namespace {
+
+const int MAX_EVENTS = 256;
+const size_t READ_CHUNK = 64 * 1024;
+
+} // namespace
+
+Reactor::Reactor(int port, ConnectionHandler& handler)
+    : port(port), handler(handler), listenFd(-1), epollFd(-1), wakeFd(-1), stopping(false) {}
+
+Reactor::~Reactor() {
+    if (listenFd != -1) close(listenFd);
+    if (epollFd != -1) close(epollFd);
+    if (wakeFd != -1) close(wakeFd);
+}
+
+bool Reactor::open() {
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd == -1) {
+        LOG_ERROR("socket failed: " << std::strerror(errno));
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in server_addr{};
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    server_addr.sin_port = htons(port);
+
+    if (bind(listenFd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
+        LOG_ERROR("bind failed: " << std::strerror(errno));
+        return false;
+    }
+
+    if (listen(listenFd, SOMAXCONN) < 0) {
+        LOG_ERROR("listen failed: " << std::strerror(errno));
+        return false;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd == -1 || wakeFd == -1) {
+        LOG_ERROR("epoll setup failed: " << std::strerror(errno));
+        return false;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    LOG_INFO("Server is listening on port " << port << " (epoll)");
+    return true;
+}
+
+void Reactor::run() {
+    epoll_event events[MAX_EVENTS];
+
+    while (!stopping.load(std::memory_order_acquire)) {
+        int n = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            LOG_ERROR("epoll_wait failed: " << std::strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptClients();
+                continue;
+            }
+            if (fd == wakeFd) {
+                // stop() (the loop condition handles it) or recheckConnections()
+                uint64_t value;
+                if (read(wakeFd, &value, sizeof(value)) < 0) {
+                    // Already drained
+                }
+                std::vector<int> retry(paused.begin(), paused.end());
+                for (int pausedFd : retry) {
+                    auto it = connections.find(pausedFd);
+                    if (it != connections.end()) retryPaused(it->second);
+                }
+                std::vector<int> recheck(closing.begin(), closing.end());
+                for (int closingFd : recheck) {
+                    auto it = connections.find(closingFd);
+                    if (it != connections.end()) finishClosing(it->second);
+                }
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;
+            std::shared_ptr<Connection> conn = it->second;
+
+            if (events[i].events & EPOLLOUT) {
+                conn->flushPending();
+            }
+            if (closing.count(fd)) {
+                finishClosing(conn);
+            } else if (paused.count(fd)) {
+                retryPaused(conn); // Reads on from where it stopped, if resumed
+            } else if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLRDHUP)) {
+                readClient(conn);
+            }
+        }
+    }
+
+    for (auto& entry : connections) {
+        entry.second->markClosed();
+        handler.onDisconnect(entry.second);
+    }
+    connections.clear();
+    paused.clear();
+    closing.clear();
+}
+
+void Reactor::stop() {
+    stopping.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    if (wakeFd != -1 && write(wakeFd, &one, sizeof(one)) < 0) {
+        // Nothing to do: the counter is already non-zero, the loop will wake
+    }
+}
+
+void Reactor::recheckConnections() {
+    uint64_t one = 1;
+    if (wakeFd != -1 && write(wakeFd, &one, sizeof(one)) < 0) {
+        // Counter already non-zero: the loop is waking anyway
+    }
+}
+
+void Reactor::acceptClients() {
+    while (true) {
+        sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_fd = accept4(listenFd, (struct sockaddr *)&client_addr, &client_len,
+                                SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("accept failed: " << std::strerror(errno));
+            }
+            return;
+        }
+
+        int nodelay = 1;
+        setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        auto conn = std::make_shared<Connection>(client_fd);
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = client_fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, client_fd, &ev) < 0) {
+            LOG_ERROR("epoll_ctl failed: " << std::strerror(errno));
+            continue; // conn's destructor closes the socket
+        }
+
+        connections[client_fd] = conn;
+        LOG_INFO("Accepted client connection. Client FD: " << client_fd);
+        handler.onConnect(conn);
+    }
+}
+
+void Reactor::readClient(const std::shared_ptr<Connection>& conn) {
+    char buffer[READ_CHUNK];
+
+    // Edge-triggered: keep reading until the kernel buffer is empty
+    while (true) {
+        ssize_t bytes_read = read(conn->fd(), buffer, sizeof(buffer));
+        if (bytes_read > 0) {
+            conn->inBuf.append(buffer, bytes_read);
+            if (!handler.onData(conn)) {
+                // Leave the rest in the kernel; it is read after a retry
+                paused.insert(conn->fd());
+                return;
+            }
+        } else if (bytes_read == 0) {
+            LOG_INFO("Client disconnected. Client FD: " << conn->fd());
+            closeInput(conn);
+            return;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+        } else {
+            LOG_ERROR("Failed to read from fd " << conn->fd() << ": " << std::strerror(errno));
+            dropClient(conn, true);
+            return;
+        }
+    }
+}
+
+void Reactor::retryPaused(const std::shared_ptr<Connection>& conn) {
+    if (handler.onData(conn)) {
+        paused.erase(conn->fd());
+        // Edge-triggered: bytes that arrived meanwhile raise no new event
+        readClient(conn);
+    }
+}
+
+void Reactor::closeInput(const std::shared_ptr<Connection>& conn) {
+    // The client may only have half-closed. Replies to its last commands can
+    // still be in the pipeline or in outBuf, and only EPOLLOUT flushes what
+    // the socket did not take at once, so the fd stays registered until then.
+    closing.insert(conn->fd());
+    handler.onInputClosed(conn);
+    finishClosing(conn);
+}
+
+void Reactor::finishClosing(const std::shared_ptr<Connection>& conn) {
+    // Pipeline work first: replies it still sends would land in outBuf
+    if (!handler.hasPendingWork(conn) && conn->pendingOutput() == 0) {
+        dropClient(conn, false);
+    }
+}
+
+void Reactor::dropClient(const std::shared_ptr<Connection>& conn, bool failed) {
+    // The socket closes with its last owner
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd(), nullptr);
+    if (failed) conn->markClosed();
+    handler.onDisconnect(conn);
+    paused.erase(conn->fd());
+    closing.erase(conn->fd());
+    connections.erase(conn->fd());
+}
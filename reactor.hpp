@@ -0,0 +1,47 @@
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#include "connection.hpp"
+#include "io_backend.hpp"
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+// Single-threaded, edge-triggered epoll event loop. Accepts clients on a
+// listening socket, reads every readable connection until EAGAIN into its
+// inBuf and hands it to the ConnectionHandler, and flushes buffered writes
+// when sockets become writable. Idle connections cost a buffer, not a thread.
+// A connection the handler paused is left unread, so the kernel's receive
+// window pushes back on that client alone, until a retry succeeds. After EOF
+// a connection stays registered for writing until its replies have gone out.
+class Reactor : public IOBackend {
+public:
+    Reactor(int port, ConnectionHandler& handler);
+    ~Reactor() override;
+
+    bool open() override;
+    void run() override;
+    void stop() override;
+    void recheckConnections() override;
+
+private:
+    void acceptClients();
+    void readClient(const std::shared_ptr<Connection>& conn);
+    void retryPaused(const std::shared_ptr<Connection>& conn);
+    void closeInput(const std::shared_ptr<Connection>& conn);
+    void finishClosing(const std::shared_ptr<Connection>& conn);
+    void dropClient(const std::shared_ptr<Connection>& conn, bool failed);
+
+    int port;
+    ConnectionHandler& handler;
+    int listenFd;
+    int epollFd;
+    int wakeFd; // eventfd used by stop() and recheckConnections()
+    std::atomic<bool> stopping;
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;
+    std::unordered_set<int> paused;  // Connections whose reading onData paused
+    std::unordered_set<int> closing; // Connections past EOF, waiting for their replies
+};
+
+#endif // REACTOR_HPP
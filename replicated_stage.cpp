@@ -0,0 +1,22 @@
+#include "replicated_stage.hpp"
+#include <algorithm>
+
+ReplicatedStage::ReplicatedStage(size_t replicaCount, size_t capacity) {
+    replicaCount = std::max<size_t>(1, replicaCount);
+    for (size_t i = 0; i < replicaCount; ++i) {
+        replicas.push_back(std::make_unique<ActiveObject>(capacity));
+    }
+}
+
+ActiveObject::Stats ReplicatedStage::stats() const {
+    ActiveObject::Stats total{};
+    for (const auto& replica : replicas) {
+        ActiveObject::Stats stats = replica->stats();
+        total.capacity = stats.capacity;
+        total.depth += stats.depth;
+        total.peakDepth = std::max(total.peakDepth, stats.peakDepth);
+        total.blockedCount += stats.blockedCount;
+        total.blockedNanos += stats.blockedNanos;
+    }
+    return total;
+}
@@ -0,0 +1,35 @@
+#ifndef REPLICATED_STAGE_HPP
+#define REPLICATED_STAGE_HPP
+
+#include "ActiveObject.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// A pipeline stage run by several ActiveObjects. Every task carries a shard
+// key (the connection), and all tasks with the same key go to the same
+// replica, so they still run one at a time and in enqueue order while
+// different keys are processed in parallel.
+class ReplicatedStage {
+public:
+    // replicas == 0 is treated as 1; capacity applies to each replica
+    ReplicatedStage(size_t replicas, size_t capacity);
+
+    void enqueueTask(size_t key, InlineTask task) {
+        replicas[key % replicas.size()]->enqueueTask(std::move(task));
+    }
+
+    // Whether key's replica has room (see ActiveObject::hasRoom)
+    bool hasRoom(size_t key) const { return replicas[key % replicas.size()]->hasRoom(); }
+
+    size_t replicaCount() const { return replicas.size(); }
+
+    // Depths and blocked counters summed over the replicas; peakDepth and
+    // capacity are those of a single replica (the largest peak)
+    ActiveObject::Stats stats() const;
+
+private:
+    std::vector<std::unique_ptr<ActiveObject>> replicas;
+};
+
+#endif // REPLICATED_STAGE_HPP
@@ -1,19 +1,26 @@
 #include "responseStage.hpp"
-#include <iostream>
+#include "logger.hpp"
+#include <cerrno>
+#include <cstring>
 #include <unistd.h>
 
 void responseStage::process(std::shared_ptr<pipelineData> data) {
     if (data && data->client_fd != -1) {
-        std::cout << "Sending response to client (FD: " << data->client_fd << "): " << data->response << std::endl;
+        LOG_DEBUG("Sending response to client (FD: " << data->client_fd << "): " << data->response);
         
+        if (data->connection) {
+            data->connection->send(data->response);
+            return;
+        }
+
         ssize_t bytes_written = write(data->client_fd, data->response.c_str(), data->response.length());
         
         if (bytes_written == -1) {
-            perror("Failed to write to client");
+            LOG_ERROR("Failed to write to client: " << std::strerror(errno));
         } else {
-            std::cout << "Response successfully written to Client FD: " << data->client_fd << std::endl;
+            LOG_DEBUG("Response successfully written to Client FD: " << data->client_fd);
         }
     } else {
-        std::cerr << "Invalid pipeline data or client_fd. Response not sent." << std::endl;
+        LOG_WARN("Invalid pipeline data or client_fd. Response not sent.");
     }
 }
@@ -0,0 +1,203 @@
+#include "scheduler.hpp"
+#include "futex.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <climits>
+#include <exception>
+
+namespace {
+
+// Failed findTask rounds (with a yield between) before a worker parks
+const int SPIN_ROUNDS = 64;
+
+// Worker identity of the current thread, so submit can use its own deque
+thread_local Scheduler* currentScheduler = nullptr;
+thread_local unsigned currentWorker = 0;
+
+uint64_t xorshift(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+} // namespace
+
+Scheduler::Scheduler(unsigned numWorkers) {
+    if (numWorkers == 0) {
+        numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < numWorkers; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+    }
+    // Start the threads only once every deque exists, since they steal from each other
+    for (unsigned i = 0; i < numWorkers; ++i) {
+        workers[i]->thread = std::thread(&Scheduler::workerLoop, this, i);
+    }
+}
+
+Scheduler::~Scheduler() {
+    stopping.store(true, std::memory_order_seq_cst);
+    epoch.fetch_add(1, std::memory_order_seq_cst);
+    futexWake(epoch, INT_MAX);
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+Scheduler& Scheduler::instance() {
+    // Never destroyed: tasks may still be running while static destructors run
+    static Scheduler* scheduler = new Scheduler();
+    return *scheduler;
+}
+
+void Scheduler::submit(Task task) {
+    Task* item = new Task(std::move(task));
+    if (currentScheduler == this) {
+        workers[currentWorker]->deque.push(item);
+    } else {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        injected.push_back(item);
+        injectedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    wakeOne();
+}
+
+void Scheduler::wakeOne() {
+    // Pairs with the fence in workerLoop: either the parking worker sees the
+    // new task, or this thread sees the worker parked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked.load(std::memory_order_relaxed) > 0) {
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(epoch, 1);
+    }
+}
+
+Scheduler::Task* Scheduler::takeInjected() {
+    if (injectedCount.load(std::memory_order_relaxed) == 0) return nullptr;
+
+    std::lock_guard<std::mutex> lock(injectedMutex);
+    if (injected.empty()) return nullptr;
+    Task* item = injected.front();
+    injected.pop_front();
+    injectedCount.fetch_sub(1, std::memory_order_relaxed);
+    return item;
+}
+
+Scheduler::Task* Scheduler::stealFrom(unsigned self) {
+    size_t count = workers.size();
+    if (count < 2) return nullptr;
+
+    // Start at a random victim so thieves spread over the workers
+    size_t start = xorshift(workers[self]->rng) % count;
+    for (size_t i = 0; i < count; ++i) {
+        size_t victim = (start + i) % count;
+        if (victim == self) continue;
+        if (Task* item = workers[victim]->deque.steal()) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+Scheduler::Task* Scheduler::findTask(unsigned self) {
+    if (Task* item = workers[self]->deque.pop()) return item;
+    if (Task* item = takeInjected()) return item;
+    return stealFrom(self);
+}
+
+bool Scheduler::hasQueuedWork() const {
+    if (injectedCount.load(std::memory_order_relaxed) > 0) return true;
+    for (const auto& worker : workers) {
+        if (!worker->deque.empty()) return true;
+    }
+    return false;
+}
+
+void Scheduler::run(Task* item) {
+    std::unique_ptr<Task> task(item);
+    try {
+        (*task)();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Scheduler task failed: " << e.what());
+    }
+}
+
+void Scheduler::workerLoop(unsigned index) {
+    currentScheduler = this;
+    currentWorker = index;
+
+    int idleRounds = 0;
+    while (true) {
+        if (Task* item = findTask(index)) {
+            run(item);
+            idleRounds = 0;
+            continue;
+        }
+        if (++idleRounds < SPIN_ROUNDS) {
+            std::this_thread::yield();
+            continue;
+        }
+        idleRounds = 0;
+
+        // Queued tasks are finished before a stopping scheduler lets go
+        if (stopping.load(std::memory_order_acquire) && !hasQueuedWork()) {
+            return;
+        }
+
+        // Park until a submit bumps the epoch. Reading the epoch before the
+        // final check means a wake-up in between makes futexWait return at once.
+        uint32_t key = epoch.load(std::memory_order_seq_cst);
+        parked.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!hasQueuedWork() && !stopping.load(std::memory_order_acquire)) {
+            futexWait(epoch, key);
+        }
+        parked.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+void Scheduler::parallelFor(size_t n, size_t numChunks, const std::function<void(size_t, size_t, size_t)>& body) {
+    if (numChunks <= 1) {
+        body(0, 0, n);
+        return;
+    }
+
+    // Chunks are claimed from a shared counter by the caller and by helper
+    // tasks. A helper that starts after the last chunk was claimed finds
+    // nothing and never touches body, so the caller may return first.
+    struct Progress {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+    };
+    auto progress = std::make_shared<Progress>();
+    size_t chunkSize = (n + numChunks - 1) / numChunks;
+    auto work = [progress, &body, n, numChunks, chunkSize]() {
+        size_t chunk;
+        while ((chunk = progress->next.fetch_add(1, std::memory_order_relaxed)) < numChunks) {
+            size_t begin = std::min(n, chunk * chunkSize);
+            size_t end = std::min(n, begin + chunkSize);
+            body(chunk, begin, end);
+            progress->done.fetch_add(1, std::memory_order_release);
+        }
+    };
+
+    size_t helpers = std::min<size_t>(numChunks - 1, workers.size());
+    for (size_t i = 0; i < helpers; ++i) {
+        submit(work);
+    }
+    work();
+
+    // Wait for chunks still running elsewhere; a worker keeps busy meanwhile
+    while (progress->done.load(std::memory_order_acquire) < numChunks) {
+        Task* item = currentScheduler == this ? findTask(currentWorker) : nullptr;
+        if (item) {
+            run(item);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include "inline_task.hpp"
+#include "work_stealing_deque.hpp"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing task scheduler shared by the servers and the parallel
+// solvers. Every worker owns a Chase-Lev deque: tasks submitted from a
+// worker go to its own deque (LIFO, cache-warm), tasks from other threads
+// to a shared injection queue. An idle worker steals from a random victim,
+// and when there is nothing to steal it parks on a futex; a submit wakes a
+// single parked worker, and only if one is parked.
+class Scheduler {
+public:
+    using Task = InlineTask;
+
+    // numWorkers == 0 uses std::thread::hardware_concurrency()
+    explicit Scheduler(unsigned numWorkers = 0);
+
+    // Finishes the queued tasks, then joins the workers
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Process-wide scheduler with one worker per hardware thread
+    static Scheduler& instance();
+
+    void submit(Task task);
+
+    // Run body(chunk, begin, end) over [0, n) split into numChunks contiguous
+    // chunks and return once all are done. The calling thread works on the
+    // chunks too, so it is safe to call from inside a task.
+    void parallelFor(size_t n, size_t numChunks, const std::function<void(size_t, size_t, size_t)>& body);
+
+    unsigned workerCount() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    struct Worker {
+        WorkStealingDeque<Task> deque;
+        std::thread thread;
+        uint64_t rng; // xorshift state for picking victims
+    };
+
+    void workerLoop(unsigned index);
+    Task* findTask(unsigned self);
+    Task* takeInjected();
+    Task* stealFrom(unsigned self);
+    bool hasQueuedWork() const;
+    void run(Task* task);
+    void wakeOne();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex injectedMutex;
+    std::deque<Task*> injected;
+    std::atomic<size_t> injectedCount{0};
+
+    // Parking: idle workers sleep on epoch; a waker bumps it and wakes one
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<unsigned> parked{0};
+    std::atomic<bool> stopping{false};
+};
+
+#endif // SCHEDULER_HPP
@@ -2,150 +2,618 @@
 #include "task.hpp"
 #include "mst_solver.hpp"
 #include "mst_factory.hpp"  // Include the MSTFactory header
-#include <iostream>
-#include <sstream>
-#include <unistd.h>
-#include <sys/socket.h>
-#include <arpa/inet.h>
+#include "binaryProtocol.hpp"
+#include "graph_file.hpp"
+#include "logger.hpp"
+#include <cctype>
+#include <climits>
 #include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+// Largest edge count accepted by a single addbatch command
+static const size_t MAX_BATCH_EDGES = size_t(1) << 26;
+
+// Parse "addbatch <count>"; both the event loop and the command handler use
+// this so they agree on which lines start a batch
+static bool parseBatchCount(const std::string& command, size_t& count) {
+    std::istringstream iss(command);
+    std::string cmd;
+    long long value;
+    if (!(iss >> cmd) || cmd != "addbatch" || !(iss >> value)) return false;
+    if (value <= 0 || static_cast<unsigned long long>(value) > MAX_BATCH_EDGES) return false;
+    count = static_cast<size_t>(value);
+    return true;
+}
 
-server::server(int port) : port(port) {}
+// Parse one decimal int at p, skipping blanks but never crossing the end of the line
+static bool parseInt(const char*& p, const char* end, int& value) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    bool negative = p < end && *p == '-';
+    if (negative || (p < end && *p == '+')) ++p;
+    const char* digits = p;
+    long long result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + (*p++ - '0');
+        if (result > INT_MAX + 1LL) return false;
+    }
+    if (p == digits) return false;
+    result = negative ? -result : result;
+    if (result > INT_MAX || result < INT_MIN) return false;
+    value = static_cast<int>(result);
+    return true;
+}
+
+// Shard key of a session: all of its tasks go to the same stage replicas
+static size_t shardOf(const pipelineData& data) {
+    return static_cast<size_t>(data.client_fd);
+}
+
+server::server(int port, std::string ioBackend, const PipelineConfig& config)
+    : commandProcessing(config.commandProcessingReplicas, config.commandProcessingCapacity),
+      graphUpdate(config.graphUpdateReplicas, config.graphUpdateCapacity),
+      mstComputation(config.mstComputationReplicas, config.mstComputationCapacity),
+      response(config.responseReplicas, config.responseCapacity),
+      port(port),
+      ioBackendName(std::move(ioBackend)),
+      outputLimit(config.connectionOutputLimit) {
+    arenaOptions.hugePages = config.hugePages;
+}
 
 void server::start() {
-    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd == -1) {
-        perror("socket failed");
+    backend = createIOBackend(ioBackendName, port, *this);
+    if (!backend->open()) {
         return;
     }
+    backend->run();
+}
 
-    sockaddr_in server_addr{};
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port = htons(port);
+void server::stop() {
+    LOG_INFO("Stopping server...");
+    if (backend) {
+        backend->stop();
+    }
+}
 
-    if (bind(server_fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
-        perror("bind failed");
-        close(server_fd);
-        return;
+void server::onConnect(const std::shared_ptr<Connection>& conn) {
+    auto data = std::make_shared<pipelineData>(std::make_shared<SessionArena>(arenaOptions));
+    data->client_fd = conn->fd();
+    data->connection = conn;
+    sessions[conn.get()] = data;
+}
+
+bool server::onData(const std::shared_ptr<Connection>& conn) {
+    auto it = sessions.find(conn.get());
+    if (it == sessions.end()) return true;
+    std::shared_ptr<pipelineData> data = it->second;
+
+    if (data->waitingForRoom) {
+        data->waitingForRoom = false;
+        pausedReads.fetch_sub(1, std::memory_order_seq_cst);
     }
+    while (!frameInput(data, conn)) {
+        // The backend retries once output to the client makes progress
+        if (conn->pendingOutput() > outputLimit) return false;
 
-    if (listen(server_fd, 3) < 0) {
-        perror("listen failed");
-        close(server_fd);
-        return;
+        // Announce the wait before looking again, so a commandProcessing task
+        // that frees room in between sees it in roomFreed()
+        pausedReads.fetch_add(1, std::memory_order_seq_cst);
+        if (!commandProcessing.hasRoom(shardOf(*data))) {
+            data->waitingForRoom = true;
+            return false;
+        }
+        pausedReads.fetch_sub(1, std::memory_order_seq_cst);
     }
+    return true;
+}
 
-    std::cout << "Server is listening on port " << port << std::endl;
+bool server::frameInput(const std::shared_ptr<pipelineData>& data, const std::shared_ptr<Connection>& conn) {
+    // The first byte of a connection picks its protocol
+    if (data->protocol == ProtocolMode::Unknown) {
+        if (conn->pendingSize() == 0) return true;
+        bool binary = static_cast<uint8_t>(conn->pendingData()[0]) == binaryProtocol::MAGIC;
+        data->protocol = binary ? ProtocolMode::Binary : ProtocolMode::Text;
+    }
+    bool binary = data->protocol == ProtocolMode::Binary;
+
+    // Only complete commands are dispatched; a partial one stays in inBuf.
+    // Input is only consumed while the task carrying it can be queued without
+    // waiting. The event loop is the only producer of commandProcessing, so
+    // room seen here is still there when the framed commands are dispatched.
+    std::vector<std::string> commands;
+    auto canTakeInput = [&]() {
+        return !commands.empty() ||
+               (conn->pendingOutput() <= outputLimit && commandProcessing.hasRoom(shardOf(*data)));
+    };
+    if (binary) {
+        binaryProtocol::FrameHeader header;
+        while (conn->pendingSize() >= binaryProtocol::HEADER_SIZE) {
+            if (!canTakeInput()) return false;
+            if (!binaryProtocol::parseHeader(conn->pendingData(), header) ||
+                header.length > binaryProtocol::MAX_PAYLOAD) {
+                // Replied to on commandProcessing, after the frames before it
+                dispatchCommands(data, binary, commands);
+                if (!canTakeInput()) return false;
 
-    while (true) {
-        sockaddr_in client_addr;
-        socklen_t client_len = sizeof(client_addr);
-        int client_fd = accept(server_fd, (struct sockaddr *)&client_addr, &client_len);
-        if (client_fd < 0) {
-            perror("accept failed");
-            continue;
+                // Framing is lost; there is no way to resynchronise the stream
+                LOG_WARN("Malformed binary frame from Client FD: " << conn->fd() << ", discarding input");
+                conn->consume(conn->pendingSize());
+                enqueueCommandTask(data, [this, data]() {
+                    roomFreed();
+                    respond(data, data->nextRequestSeq++,
+                            binaryProtocol::errorFrame(0, binaryProtocol::STATUS_INVALID_INPUT, "Malformed frame"));
+                    commandTaskDone(*data);
+                });
+                break;
+            }
+            size_t frameSize = binaryProtocol::HEADER_SIZE + header.length;
+            if (conn->pendingSize() < frameSize) break;
+            commands.emplace_back(conn->pendingData(), frameSize);
+            conn->consume(frameSize);
         }
+    } else {
+        std::string line;
+        while (true) {
+            if (!canTakeInput()) return false;
+            if (data->batchLinesLeft > 0) {
+                // Inside an addbatch: hand the complete edge lines over as one raw
+                // block so they are inserted as they arrive, without per-line strings
+                const char* begin = conn->pendingData();
+                const char* end = begin + conn->pendingSize();
+                const char* blockEnd = begin;
+                size_t lines = 0;
+                while (lines < data->batchLinesLeft) {
+                    const char* newline = static_cast<const char*>(std::memchr(blockEnd, '\n', end - blockEnd));
+                    if (!newline) break;
+                    blockEnd = newline + 1;
+                    ++lines;
+                }
+                if (lines == 0) break;
 
-        std::cout << "Accepted client connection. Client FD: " << client_fd << std::endl;
+                // Keep command order: lines framed before the block go first
+                dispatchCommands(data, binary, commands);
+                if (!canTakeInput()) return false;
+                std::string block(begin, blockEnd);
+                conn->consume(blockEnd - begin);
+                data->batchLinesLeft -= lines;
+                enqueueCommandTask(data, [this, data, block = std::move(block), lines]() {
+                    roomFreed();
+                    handleEdgeBlock(data, block, lines);
+                    commandTaskDone(*data);
+                });
+                continue;
+            }
 
-        auto data = std::make_shared<pipelineData>();
-        data->client_fd = client_fd;
+            if (!conn->nextLine(line)) break;
+            if (line.empty()) continue;
+            size_t count;
+            if (parseBatchCount(line, count)) {
+                data->batchLinesLeft = count;
+            }
+            commands.push_back(std::move(line));
+        }
+    }
+    dispatchCommands(data, binary, commands);
+    return true;
+}
 
-        commandProcessing.enqueueTask([this, client_fd, data]() { handleClient(client_fd, data); });
+void server::enqueueCommandTask(const std::shared_ptr<pipelineData>& data, InlineTask task) {
+    data->commandTasks.fetch_add(1, std::memory_order_seq_cst);
+    commandProcessing.enqueueTask(shardOf(*data), std::move(task));
+}
+
+void server::roomFreed() {
+    if (pausedReads.load(std::memory_order_seq_cst) > 0) {
+        backend->recheckConnections();
     }
+}
 
-    close(server_fd);
+void server::commandTaskDone(pipelineData& data) {
+    data.commandTasks.fetch_sub(1, std::memory_order_seq_cst);
+    workDone(data);
 }
 
-void server::stop() {
-    std::cout << "Stopping server..." << std::endl;
-}
-
-void server::handleClient(int client_fd, std::shared_ptr<pipelineData> data) {
-    char buffer[1024];
-    while (true) {
-        memset(buffer, 0, sizeof(buffer));
-        int bytes_read = read(client_fd, buffer, sizeof(buffer) - 1);
-        if (bytes_read > 0) {
-            buffer[bytes_read] = '\0';
-            std::string command(buffer);
-            std::cout << "Received command: " << command << std::endl;
-
-            std::istringstream iss(command);
-            std::string cmd;
-            iss >> cmd;
-            data->command = cmd;
-
-            if (cmd == "create") {
-                int V, E;
-                if (iss >> V >> E) {
-                    data->graph = Graph(V);
-                    data->response = "Graph created with " + std::to_string(V) + " vertices and " + std::to_string(E) + " edges.\n";
-                    graphUpdate.enqueueTask([this, data]() {
-                        response.enqueueTask([data]() {
-                            write(data->client_fd, data->response.c_str(), data->response.length());
-                        });
-                    });
+void server::workDone(pipelineData& data) {
+    // Pairs with onInputClosed: either the event loop sees this task's
+    // counter update, or this sees inputClosed and wakes the loop
+    if (data.inputClosed.load(std::memory_order_seq_cst)) {
+        backend->recheckConnections();
+    }
+}
+
+void server::dispatchCommands(std::shared_ptr<pipelineData> data, bool binary, std::vector<std::string>& commands) {
+    if (commands.empty()) return;
+
+    enqueueCommandTask(data, [this, data, binary, commands = std::move(commands)]() {
+        roomFreed();
+        for (const std::string& command : commands) {
+            if (binary) {
+                handleBinaryCommand(data, command);
+            } else {
+                handleCommand(data, command);
+            }
+        }
+        commandTaskDone(*data);
+    });
+    commands.clear();
+}
+
+void server::onInputClosed(const std::shared_ptr<Connection>& conn) {
+    auto it = sessions.find(conn.get());
+    if (it != sessions.end()) {
+        it->second->inputClosed.store(true, std::memory_order_seq_cst);
+    }
+}
+
+bool server::hasPendingWork(const std::shared_ptr<Connection>& conn) {
+    auto it = sessions.find(conn.get());
+    if (it == sessions.end()) return false;
+    const pipelineData& data = *it->second;
+
+    // Once no commandProcessing task is left, every command has its number,
+    // and each gets exactly one reply; only an addbatch cut short by the EOF
+    // never answers, and nothing follows it
+    if (data.commandTasks.load(std::memory_order_seq_cst) > 0) return true;
+    uint64_t replies = data.nextRequestSeq.load(std::memory_order_seq_cst) - (data.batchLinesLeft > 0 ? 1 : 0);
+    return data.nextResponseSeq.load(std::memory_order_seq_cst) != replies;
+}
+
+void server::onDisconnect(const std::shared_ptr<Connection>& conn) {
+    auto it = sessions.find(conn.get());
+    if (it != sessions.end() && it->second->waitingForRoom) {
+        pausedReads.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    sessions.erase(conn.get());
+}
+
+void server::respond(std::shared_ptr<pipelineData> data, uint64_t seq, std::string text) {
+    size_t shard = shardOf(*data);
+    response.enqueueTask(shard, [this, data = std::move(data), seq, text = std::move(text)]() mutable {
+        if (seq != data->nextResponseSeq) {
+            // An earlier command's reply is still on its way
+            data->heldResponses.emplace(seq, std::move(text));
+            return;
+        }
+        data->connection->send(text);
+        ++data->nextResponseSeq;
+
+        // Send the replies that were waiting for this one
+        auto held = data->heldResponses.begin();
+        while (held != data->heldResponses.end() && held->first == data->nextResponseSeq) {
+            data->connection->send(held->second);
+            ++data->nextResponseSeq;
+            held = data->heldResponses.erase(held);
+        }
+        workDone(*data);
+    });
+}
+
+void server::handleCommand(std::shared_ptr<pipelineData> data, const std::string& command) {
+    LOG_DEBUG("Received command: " << command);
+
+    std::istringstream iss(command);
+    std::string cmd;
+    iss >> cmd;
+    data->command = cmd;
+    uint64_t seq = data->nextRequestSeq++;
+
+    if (cmd == "create") {
+        // "create V E" makes a private graph, "create name V" a shared one
+        std::string first;
+        iss >> first;
+        std::istringstream firstArg(first);
+        int V, E;
+        std::string text;
+        if (firstArg >> V && firstArg.eof() && iss >> E && V >= 0) {
+            data->graph = std::make_shared<SharedGraph>(Graph(V, data->arena));
+            data->graphName.clear();
+            text = "Graph created with " + std::to_string(V) + " vertices and " + std::to_string(E) + " edges.\n";
+        } else if (!first.empty() && std::isalpha(static_cast<unsigned char>(first[0])) && iss >> V && V >= 0) {
+            data->graph = registry.create(first, Graph(V, std::make_shared<SessionArena>(arenaOptions)));
+            data->graphName = first;
+            text = "Graph " + first + " created with " + std::to_string(V) + " vertices.\n";
+        } else {
+            respond(data, seq, "Invalid input for create command.\n");
+            return;
+        }
+        graphUpdate.enqueueTask(shardOf(*data), [this, data, seq, text]() {
+            respond(data, seq, text);
+        });
+    } else if (cmd == "use") {
+        std::string name;
+        if (iss >> name) {
+            std::shared_ptr<SharedGraph> graph = registry.find(name);
+            if (graph) {
+                data->graph = graph;
+                data->graphName = name;
+                std::shared_ptr<GraphSnapshot> snapshot = graph->snapshot();
+                respond(data, seq, "Using graph " + name + " with " + std::to_string(snapshot->graph.getV()) + " vertices and " +
+                              std::to_string(snapshot->graph.getEdges().size()) + " edges.\n");
+            } else {
+                respond(data, seq, "No graph named " + name + ".\n");
+            }
+        } else {
+            respond(data, seq, "Invalid input for use command.\n");
+        }
+    } else if (cmd == "add") {
+        int v, w, weight;
+        if (iss >> v >> w >> weight) {
+            // Checked up front so a rejected edge does not copy the graph
+            if (!data->graph->hasVertex(v) || !data->graph->hasVertex(w)) {
+                respond(data, seq, "Vertex out of range.\n");
+                return;
+            }
+            data->graph->write([&](Graph& graph) {
+                graph.addEdge(v, w, weight);
+            });
+            // Built in place: chained operator+ reallocates as it grows
+            std::string reply;
+            reply.reserve(64);
+            reply.append("Edge added: ").append(std::to_string(v)).append(" -> ").append(std::to_string(w));
+            reply.append(" with weight ").append(std::to_string(weight)).append(".\n");
+            respond(data, seq, std::move(reply));
+        } else {
+            respond(data, seq, "Invalid input for add command.\n");
+        }
+    } else if (cmd == "remove") {
+        int v, w;
+        if (iss >> v >> w) {
+            if (!data->graph->hasVertex(v) || !data->graph->hasVertex(w)) {
+                respond(data, seq, "Vertex out of range.\n");
+                return;
+            }
+            size_t removed = data->graph->write([&](Graph& graph) {
+                return graph.removeEdge(v, w);
+            });
+            if (removed > 0) {
+                respond(data, seq, "Edge removed: " + std::to_string(v) + " -> " + std::to_string(w) + ".\n");
+            } else {
+                respond(data, seq, "No edge between " + std::to_string(v) + " and " + std::to_string(w) + ".\n");
+            }
+        } else {
+            respond(data, seq, "Invalid input for remove command.\n");
+        }
+    } else if (cmd == "addbatch") {
+        size_t count;
+        if (parseBatchCount(command, count)) {
+            // The edge lines follow as handleEdgeBlock calls
+            data->graph->write([count](Graph& graph) {
+                graph.reserveEdges(count);
+            });
+            data->batchPending = count;
+            data->batchAdded = 0;
+            data->batchRejected = 0;
+            data->batchSeq = seq;
+        } else {
+            respond(data, seq, "Invalid input for addbatch command.\n");
+        }
+    } else if (cmd == "load") {
+        // "load path" replaces the private graph, "load path name" publishes a shared one
+        std::string path, name;
+        if (iss >> path) {
+            iss >> name;
+            try {
+                Graph graph = graphFile::load(path, name.empty() ? data->arena
+                                                                 : std::make_shared<SessionArena>(arenaOptions));
+                std::string text = "Graph loaded from " + path + " with " + std::to_string(graph.getV()) +
+                                   " vertices and " + std::to_string(graph.getEdges().size()) + " edges.\n";
+                if (name.empty()) {
+                    data->graph = std::make_shared<SharedGraph>(std::move(graph));
                 } else {
-                    data->response = "Invalid input for create command.\n";
-                    response.enqueueTask([data]() {
-                        write(data->client_fd, data->response.c_str(), data->response.length());
-                    });
+                    data->graph = registry.create(name, std::move(graph));
                 }
-            } else if (cmd == "add") {
-                int v, w, weight;
-                if (iss >> v >> w >> weight) {
-                    data->graph.addEdge(v, w, weight);
-                    data->response = "Edge added: " + std::to_string(v) + " -> " + std::to_string(w) + " with weight " + std::to_string(weight) + ".\n";
-                    response.enqueueTask([data]() {
-                        write(data->client_fd, data->response.c_str(), data->response.length());
-                    });
-                } else {
-                    data->response = "Invalid input for add command.\n";
-                    response.enqueueTask([data]() {
-                        write(data->client_fd, data->response.c_str(), data->response.length());
+                data->graphName = name;
+                respond(data, seq, text);
+            } catch (const std::runtime_error& e) {
+                respond(data, seq, std::string(e.what()) + ".\n");
+            }
+        } else {
+            respond(data, seq, "Invalid input for load command.\n");
+        }
+    } else if (cmd == "save") {
+        std::string path;
+        if (iss >> path) {
+            try {
+                graphFile::save(path, data->graph->snapshot()->graph);
+                respond(data, seq, "Graph saved to " + path + ".\n");
+            } catch (const std::runtime_error& e) {
+                respond(data, seq, std::string(e.what()) + ".\n");
+            }
+        } else {
+            respond(data, seq, "Invalid input for save command.\n");
+        }
+    } else if (cmd == "stats") {
+        respond(data, seq, "MST cache hits: " + std::to_string(MSTResultCache::hits()) +
+                      ", misses: " + std::to_string(MSTResultCache::misses()) + ".\n" + stageStats());
+    } else if (cmd == "solve") {
+        std::string algo;
+        if (iss >> algo) {
+            data->algorithm = algo;
+
+            // Pin the version this command sees; later writes do not affect it
+            std::shared_ptr<SharedGraph> graph = data->graph;
+            std::shared_ptr<GraphSnapshot> snapshot = graph->snapshot();
+
+            mstComputation.enqueueTask(shardOf(*data), [this, data, seq, algo, graph, snapshot]() mutable {
+                // Use MSTFactory to create the appropriate MST solver
+                MSTAlgorithmType algoType = MSTFactory::algorithmFromName(algo);
+                auto solver = MSTFactory::createSolver(algoType);
+
+                std::string text;
+                {
+                    // Compute MST edges and statistics, unless this version was solved before
+                    std::lock_guard<std::mutex> lock(snapshot->solveMutex);
+                    solveSnapshot(*graph, *snapshot, *solver);
+
+                    // Get the MST results (the report format depends on the solver)
+                    text = snapshot->mstCache.response("text:" + std::to_string(algoType), [&solver](const MSTResult& result) {
+                        return solver->formatResults(result.edges, result.stats);
                     });
                 }
-            } else if (cmd == "solve") {
-                std::string algo;
-                if (iss >> algo) {
-                    data->algorithm = algo;
-
-                    mstComputation.enqueueTask([this, data]() {
-                        // Use MSTFactory to create the appropriate MST solver
-                        MSTAlgorithmType algoType = (data->algorithm == "prim") ? PRIM : KRUSKAL;
-                        auto solver = MSTFactory::createSolver(algoType);
-
-                        // Compute MST edges
-                        std::vector<Edge> mstEdges = solver-> solveMST(data->graph);  // Assuming the solve method returns the edges
-
-                        // Get the MST results
-                        data->response = solver->getMSTResults(data->graph, mstEdges);
-                        
-                        response.enqueueTask([data]() {
-                            write(data->client_fd, data->response.c_str(), data->response.length());
-                        });
-                    });
-                } else {
-                    data->response = "Invalid input for solve command.\n";
-                    response.enqueueTask([data]() {
-                        write(data->client_fd, data->response.c_str(), data->response.length());
-                    });
+                // Unpin the version before replying, so the client's next
+                // write can take a private graph over instead of copying it
+                snapshot.reset();
+                respond(data, seq, std::move(text));
+            });
+        } else {
+            respond(data, seq, "Invalid input for solve command.\n");
+        }
+    } else {
+        respond(data, seq, "Unknown command.\n");
+    }
+}
+
+void server::handleEdgeBlock(std::shared_ptr<pipelineData> data, const std::string& block, size_t lines) {
+    // One writer-lock acquisition for the whole block
+    data->graph->write([&](Graph& graph) {
+        const char* p = block.data();
+        const char* end = p + block.size();
+        for (size_t i = 0; i < lines; ++i) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            const char* cursor = p;
+            int v, w, weight;
+            bool parsed = parseInt(cursor, lineEnd, v) && parseInt(cursor, lineEnd, w) &&
+                          parseInt(cursor, lineEnd, weight);
+            while (parsed && cursor < lineEnd && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) ++cursor;
+
+            if (parsed && cursor == lineEnd) {
+                try {
+                    graph.addEdge(v, w, weight);
+                    ++data->batchAdded;
+                } catch (const std::out_of_range&) {
+                    ++data->batchRejected;
                 }
             } else {
-                data->response = "Unknown command.\n";
-                response.enqueueTask([data]() {
-                    write(data->client_fd, data->response.c_str(), data->response.length());
-                });
+                ++data->batchRejected;
             }
+            p = lineEnd + 1;
+        }
+    });
+
+    data->batchPending -= lines;
+    if (data->batchPending == 0) {
+        std::string text = "Batch added " + std::to_string(data->batchAdded) + " edges";
+        if (data->batchRejected > 0) {
+            text += ", rejected " + std::to_string(data->batchRejected) + " invalid lines";
+        }
+        respond(data, data->batchSeq, text + ".\n");
+    }
+}
+
+std::string server::stageStats() const {
+    const std::pair<const char*, const ReplicatedStage*> stages[] = {
+        {"commandProcessing", &commandProcessing},
+        {"graphUpdate", &graphUpdate},
+        {"mstComputation", &mstComputation},
+        {"response", &response},
+    };
+
+    std::ostringstream oss;
+    for (const auto& stage : stages) {
+        ActiveObject::Stats stats = stage.second->stats();
+        oss << "Stage " << stage.first << " x" << stage.second->replicaCount() << ": depth " << stats.depth
+            << " (peak " << stats.peakDepth << ", capacity ";
+        if (stats.capacity == 0) {
+            oss << "unbounded";
         } else {
-            if (bytes_read == 0) {
-                std::cout << "Client disconnected. Client FD: " << client_fd << std::endl;
-                close(client_fd);
-                break;
-            } else {
-                perror("Failed to read from fd");
+            oss << stats.capacity;
+        }
+        oss << "), blocked " << stats.blockedCount << " times for " << stats.blockedNanos / 1000000 << " ms.\n";
+    }
+    return oss.str();
+}
+
+const MSTResult& server::solveSnapshot(SharedGraph& graph, GraphSnapshot& snapshot, MSTSolver& solver) {
+    bool maintained = snapshot.graph.hasMaintainedMST();
+    const MSTResult& result = snapshot.mstCache.get(snapshot.graph, solver);
+
+    // A freshly seeded forest lets writes made meanwhile continue incrementally
+    std::vector<Edge> forestEdges;
+    if (!maintained && snapshot.graph.maintainedForest(forestEdges)) {
+        graph.offerMST(snapshot, forestEdges);
+    }
+    return result;
+}
+
+void server::handleBinaryCommand(std::shared_ptr<pipelineData> data, const std::string& frame) {
+    using namespace binaryProtocol;
+
+    FrameHeader header;
+    parseHeader(frame.data(), header);
+    Reader in(frame.data() + HEADER_SIZE, header.length);
+    uint8_t reply = header.opcode | RESPONSE_FLAG;
+    uint64_t seq = data->nextRequestSeq++;
+
+    if (header.opcode == OP_CREATE) {
+        uint32_t V, E;
+        if (in.u32(V) && in.u32(E) && in.atEnd() && V <= INT_MAX) {
+            data->graph = std::make_shared<SharedGraph>(Graph(static_cast<int>(V), data->arena));
+            data->graphName.clear();
+            graphUpdate.enqueueTask(shardOf(*data), [this, data, seq, reply]() {
+                respond(data, seq, binaryProtocol::frame(reply, STATUS_OK, ""));
+            });
+        } else {
+            respond(data, seq, errorFrame(header.opcode, STATUS_INVALID_INPUT, "Invalid input for create command."));
+        }
+    } else if (header.opcode == OP_ADD) {
+        uint32_t v, w;
+        int32_t weight;
+        if (in.u32(v) && in.u32(w) && in.i32(weight) && in.atEnd()) {
+            if (v > INT_MAX || w > INT_MAX || !data->graph->hasVertex(static_cast<int>(v)) ||
+                !data->graph->hasVertex(static_cast<int>(w))) {
+                respond(data, seq, errorFrame(header.opcode, STATUS_OUT_OF_RANGE, "Vertex out of range"));
+                return;
+            }
+            data->graph->write([&](Graph& graph) {
+                graph.addEdge(static_cast<int>(v), static_cast<int>(w), weight);
+            });
+            respond(data, seq, binaryProtocol::frame(reply, STATUS_OK, ""));
+        } else {
+            respond(data, seq, errorFrame(header.opcode, STATUS_INVALID_INPUT, "Invalid input for add command."));
+        }
+    } else if (header.opcode == OP_REMOVE) {
+        uint32_t v, w;
+        if (in.u32(v) && in.u32(w) && in.atEnd()) {
+            if (v > INT_MAX || w > INT_MAX || !data->graph->hasVertex(static_cast<int>(v)) ||
+                !data->graph->hasVertex(static_cast<int>(w))) {
+                respond(data, seq, errorFrame(header.opcode, STATUS_OUT_OF_RANGE, "Vertex out of range"));
+                return;
             }
+            Writer payload;
+            size_t removed = data->graph->write([&](Graph& graph) {
+                return graph.removeEdge(static_cast<int>(v), static_cast<int>(w));
+            });
+            payload.u32(static_cast<uint32_t>(removed));
+            respond(data, seq, binaryProtocol::frame(reply, STATUS_OK, payload.str()));
+        } else {
+            respond(data, seq, errorFrame(header.opcode, STATUS_INVALID_INPUT, "Invalid input for remove command."));
+        }
+    } else if (header.opcode == OP_SOLVE) {
+        uint8_t algo;
+        std::shared_ptr<MSTSolver> solver;
+        if (in.u8(algo) && in.atEnd()) {
+            solver = MSTFactory::createSolver(static_cast<MSTAlgorithmType>(algo));
+        }
+        if (!solver) {
+            respond(data, seq, errorFrame(header.opcode, STATUS_INVALID_INPUT, "Invalid input for solve command."));
+            return;
         }
+
+        std::shared_ptr<SharedGraph> graph = data->graph;
+        std::shared_ptr<GraphSnapshot> snapshot = graph->snapshot();
+        mstComputation.enqueueTask(shardOf(*data), [this, data, seq, solver, graph, snapshot]() mutable {
+            std::string frame;
+            {
+                std::lock_guard<std::mutex> lock(snapshot->solveMutex);
+                solveSnapshot(*graph, *snapshot, *solver);
+                frame = snapshot->mstCache.response("binary", [](const MSTResult& result) {
+                    return solveFrame(result.edges, result.stats);
+                });
+            }
+            snapshot.reset();
+            respond(data, seq, std::move(frame));
+        });
+    } else {
+        respond(data, seq, errorFrame(header.opcode, STATUS_UNKNOWN_OPCODE, "Unknown command."));
     }
-}
\ No newline at end of file
+}
@@ -1,15 +1,49 @@
 #ifndef SERVER_HPP
 #define SERVER_HPP
 
-#include "ActiveObject.hpp"
+#include "replicated_stage.hpp"
 #include "graph.hpp"
-#include "threadPool.hpp"
 #include "pipelineData.hpp"
+#include "connection.hpp"
+#include "io_backend.hpp"
+#include "graph_registry.hpp"
+#include "mst_solver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
-class server {
+// Replica count and per-replica queue capacity (in tasks; 0 means
+// unbounded) of each pipeline stage. Connections are sharded over the
+// replicas. A full stage blocks the stage feeding it. The event loop never
+// blocks: it stops reading a connection while that connection's
+// commandProcessing replica is full or more than connectionOutputLimit
+// bytes of its replies wait for the client, and reads on once they drain.
+struct PipelineConfig {
+    size_t commandProcessingReplicas = 1;
+    size_t graphUpdateReplicas = 1;
+    size_t mstComputationReplicas = std::max(1u, std::thread::hardware_concurrency());
+    size_t responseReplicas = 1;
+
+    size_t commandProcessingCapacity = 1024;
+    size_t graphUpdateCapacity = 1024;
+    size_t mstComputationCapacity = 256;
+    size_t responseCapacity = 4096;
+
+    size_t connectionOutputLimit = 1 << 20; // Bytes
+
+    // Session arenas put large blocks on transparent huge pages
+    bool hugePages = false;
+};
+
+class server : public ConnectionHandler {
 public:
-    server(int port);
+    // ioBackend: "epoll" (default) or "uring", see createIOBackend()
+    server(int port, std::string ioBackend = "epoll", const PipelineConfig& config = PipelineConfig());
     void start();
     void stop();
     static server& getInstance() {
@@ -17,16 +51,76 @@ public:
         return instance;
     }
     
-    // Define ActiveObjects for each pipeline stage
-    ActiveObject commandProcessing;
-    ActiveObject graphUpdate;
-    ActiveObject mstComputation;
-    ActiveObject response;
+    // Pipeline stages, each sharded by connection over its replicas
+    ReplicatedStage commandProcessing;
+    ReplicatedStage graphUpdate;
+    ReplicatedStage mstComputation;
+    ReplicatedStage response;
+
+    // Event-loop callbacks (run on the reactor thread)
+    void onConnect(const std::shared_ptr<Connection>& conn) override;
+    bool onData(const std::shared_ptr<Connection>& conn) override;
+    void onInputClosed(const std::shared_ptr<Connection>& conn) override;
+    bool hasPendingWork(const std::shared_ptr<Connection>& conn) override;
+    void onDisconnect(const std::shared_ptr<Connection>& conn) override;
     
 private:
     int port;
-    
-    void handleClient(int client_fd, std::shared_ptr<pipelineData> data);
+    std::string ioBackendName;
+    std::unique_ptr<IOBackend> backend;
+
+    // Named graphs shared by all sessions; each gets an arena of its own,
+    // since it outlives the session that created it
+    GraphRegistry registry;
+    SessionArena::Options arenaOptions;
+    size_t outputLimit;
+
+    // Sessions paused until their commandProcessing replica has room; while
+    // there are any, commandProcessing tasks call backend->recheckConnections()
+    std::atomic<size_t> pausedReads{0};
+
+    // Per-connection sessions, only touched by the reactor thread
+    std::unordered_map<Connection*, std::shared_ptr<pipelineData>> sessions;
+
+    // Run one complete command line (on the commandProcessing thread)
+    void handleCommand(std::shared_ptr<pipelineData> data, const std::string& command);
+
+    // Frame and dispatch the complete commands in conn->inBuf; false if it
+    // stopped because commandProcessing or the connection's output is full
+    bool frameInput(const std::shared_ptr<pipelineData>& data, const std::shared_ptr<Connection>& conn);
+
+    // Queue a task for data's commandProcessing replica (event-loop thread,
+    // with room checked first), counted in data->commandTasks
+    void enqueueCommandTask(const std::shared_ptr<pipelineData>& data, InlineTask task);
+
+    // Called first by every commandProcessing task: its slot is free now
+    void roomFreed();
+
+    // Called last by every commandProcessing task
+    void commandTaskDone(pipelineData& data);
+
+    // Some of data's work finished: recheck the connection if it is closing
+    void workDone(pipelineData& data);
+
+    // Hand the framed commands to the commandProcessing stage as one task
+    void dispatchCommands(std::shared_ptr<pipelineData> data, bool binary, std::vector<std::string>& commands);
+
+    // Insert a block of addbatch edge lines (on the commandProcessing thread)
+    void handleEdgeBlock(std::shared_ptr<pipelineData> data, const std::string& block, size_t lines);
+
+    // Solve a snapshot of graph (on the mstComputation thread), reusing the
+    // snapshot's cached result; call with snapshot.solveMutex held
+    const MSTResult& solveSnapshot(SharedGraph& graph, GraphSnapshot& snapshot, MSTSolver& solver);
+
+    // Run one complete binary frame (on the commandProcessing thread)
+    void handleBinaryCommand(std::shared_ptr<pipelineData> data, const std::string& frame);
+
+    // Hand the reply to command number seq of this client to the response
+    // stage, which sends the client's replies in command order
+    void respond(std::shared_ptr<pipelineData> data, uint64_t seq, std::string text);
+
+    // Queue depth and backpressure counters of every stage, for "stats"
+    std::string stageStats() const;
 };
 
-#endif // SERVER_HPP
\ No newline at end of file
+#endif // SERVER_HPP
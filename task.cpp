@@ -4,16 +4,16 @@
 #include "graphUpdateStage.hpp"
 #include "mstComputationStage.hpp"
 #include "responseStage.hpp"
-#include "server.hpp"
+#include "scheduler.hpp"
 #include <sstream>
-#include <iostream>
+#include "logger.hpp"
 #include <unistd.h>
 
 task::task(TaskType type, std::shared_ptr<pipelineData> data)
     : type_(type), data_(data) {}
 
 void task::execute() {
-    std::cout << "Executing task of type: " << static_cast<int>(type_) << " with FD: " << data_->client_fd << std::endl;
+    LOG_DEBUG("Executing task of type: " << static_cast<int>(type_) << " with FD: " << data_->client_fd);
 
     switch (type_) {
         case TaskType::GraphUpdate:
@@ -38,41 +38,17 @@ void task::execute() {
             break;
 
         default:
-            std::cerr << "Unknown task type: " << static_cast<int>(type_) << std::endl;
+            LOG_ERROR("Unknown task type: " << static_cast<int>(type_));
             break;
     }
 }
 
 void task::enqueueTask(TaskType type, std::shared_ptr<pipelineData> data) {
-    std::cout << "Enqueuing task of type: " << static_cast<int>(type) << " for FD: " << data->client_fd << std::endl;
-    
-    switch (type) {
-        case TaskType::CommandProcessing:
-            server::getInstance().commandProcessing.enqueueTask([data]() {
-                // Define the task's logic here for processing commands
-            });
-            break;
-
-        case TaskType::GraphUpdate:
-            server::getInstance().graphUpdate.enqueueTask([data]() {
-                // Define the task's logic here for updating the graph
-            });
-            break;
-
-        case TaskType::MSTComputation:
-            server::getInstance().mstComputation.enqueueTask([data]() {
-                // Define the task's logic here for computing MST
-            });
-            break;
+    LOG_DEBUG("Enqueuing task of type: " << static_cast<int>(type) << " for FD: " << data->client_fd);
 
-        case TaskType::Response:
-            server::getInstance().response.enqueueTask([data]() {
-                // Define the task's logic here for sending the response to the client
-            });
-            break;
-
-        default:
-            std::cerr << "Unknown task type!" << std::endl;
-            break;
-    }
-}
\ No newline at end of file
+    // Stages that keep per-session order run on the server's ActiveObjects;
+    // a standalone task runs on any scheduler worker
+    Scheduler::instance().submit([type, data]() {
+        task(type, data).execute();
+    });
+}
@@ -1,7 +1,7 @@
 #ifndef TASK_QUEUE_HPP
 #define TASK_QUEUE_HPP
 
-#include <functional>
+#include "inline_task.hpp"
 #include <queue>
 #include <mutex>
 #include <condition_variable>
@@ -10,17 +10,17 @@
 class TaskQueue {
 public:
     // Add a new task to the queue
-    void enqueueTask(const std::function<void()>& task) {
+    void enqueueTask(InlineTask task) {
         std::unique_lock<std::mutex> lock(mutex_);
-        taskQueue_.push(task);
+        taskQueue_.push(std::move(task));
         condition_.notify_one();  // Notify one waiting thread
     }
 
     // Fetch a task from the queue
-    std::function<void()> dequeueTask() {
+    InlineTask dequeueTask() {
         std::unique_lock<std::mutex> lock(mutex_);
         condition_.wait(lock, [this]() { return !taskQueue_.empty(); });
-        std::function<void()> task = taskQueue_.front();
+        InlineTask task = std::move(taskQueue_.front());
         taskQueue_.pop();
         return task;
     }
@@ -32,7 +32,7 @@ public:
     }
 
 private:
-    std::queue<std::function<void()>> taskQueue_; // Queue holding tasks
+    std::queue<InlineTask> taskQueue_;            // Queue holding tasks
     std::mutex mutex_;                            // Mutex for thread safety
     std::condition_variable condition_;           // Condition variable for task synchronization
 };
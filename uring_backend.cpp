@@ -0,0 +1,510 @@
+#include "uring_backend.hpp"
+#include "logger.hpp"
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+namespace {
+
+const unsigned RING_ENTRIES = 1024;
+const size_t FIXED_BUFFER_SIZE = 16 * 1024;
+const int FIXED_BUFFER_COUNT = 256;
+const size_t HEAP_BUFFER_SIZE = 16 * 1024;
+
+// user_data: connection pointer (8-byte aligned) with the operation in the low bits
+enum Op : uint64_t {
+    OP_ACCEPT = 1,
+    OP_WAKE = 2,
+    OP_READ = 3,
+    OP_WRITE = 4
+};
+const uint64_t OP_MASK = 7;
+
+int sysSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sysEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int sysRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+} // namespace
+
+// Connection whose writes are submitted by the backend's loop. The fields
+// below outputQueued are only touched on the loop thread.
+class UringConnection : public Connection {
+public:
+    UringConnection(int fd, UringBackend& backend) : Connection(fd), backend(backend) {}
+
+    std::atomic<bool> writeQueued{false};
+
+    int readSlot = -1;            // Registered buffer slot, -1 for readBuf
+    std::vector<char> readBuf;    // Fallback when no slot is free
+    std::string writeBuf;         // Bytes owned by the in-flight send
+    size_t writeOffset = 0;
+    bool writing = false;
+    bool readOpen = true;
+    bool readPaused = false;      // onData paused reading; in backend.paused
+    int inFlight = 0;
+    std::shared_ptr<Connection> keepAlive; // Held while the kernel uses our buffers
+
+protected:
+    void outputQueued() override {
+        if (!writeQueued.exchange(true)) {
+            backend.queueWrite(std::static_pointer_cast<UringConnection>(shared_from_this()));
+        }
+    }
+
+private:
+    UringBackend& backend;
+};
+
+bool UringBackend::isSupported() {
+    io_uring_params params{};
+    int fd = sysSetup(4, &params);
+    if (fd < 0) return false;
+
+    bool ok = (params.features & IORING_FEAT_SINGLE_MMAP) && (params.features & IORING_FEAT_NODROP);
+
+    // Probe for every opcode the loop submits
+    const size_t probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    std::vector<char> storage(probeSize, 0);
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    if (ok && sysRegister(fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+        for (int op : {IORING_OP_ACCEPT, IORING_OP_READ, IORING_OP_READ_FIXED, IORING_OP_RECV, IORING_OP_SEND}) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) ok = false;
+        }
+    } else {
+        ok = false;
+    }
+
+    close(fd);
+    return ok;
+}
+
+UringBackend::UringBackend(int port, ConnectionHandler& handler)
+    : port(port), handler(handler), listenFd(-1), wakeFd(-1), wakeValue(0), stopping(false),
+      multishotAccept(true), ringFd(-1), sqRing(MAP_FAILED), sqRingSize(0), cqRing(MAP_FAILED),
+      cqRingSize(0), sqes(nullptr), sqesSize(0), pendingSubmit(0) {}
+
+UringBackend::~UringBackend() {
+    connections.clear();
+    if (sqes) munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+    if (ringFd != -1) close(ringFd);
+    if (listenFd != -1) close(listenFd);
+    if (wakeFd != -1) close(wakeFd);
+}
+
+bool UringBackend::open() {
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd == -1) {
+        LOG_ERROR("socket failed: " << std::strerror(errno));
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in server_addr{};
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    server_addr.sin_port = htons(port);
+
+    if (bind(listenFd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
+        LOG_ERROR("bind failed: " << std::strerror(errno));
+        return false;
+    }
+
+    if (listen(listenFd, SOMAXCONN) < 0) {
+        LOG_ERROR("listen failed: " << std::strerror(errno));
+        return false;
+    }
+
+    wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (wakeFd == -1) {
+        LOG_ERROR("eventfd failed: " << std::strerror(errno));
+        return false;
+    }
+
+    io_uring_params params{};
+    ringFd = sysSetup(RING_ENTRIES, &params);
+    if (ringFd < 0) {
+        LOG_ERROR("io_uring_setup failed: " << std::strerror(errno));
+        return false;
+    }
+
+    // One mapping holds both rings (IORING_FEAT_SINGLE_MMAP, checked by isSupported)
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        LOG_ERROR("io_uring ring mmap failed: " << std::strerror(errno));
+        return false;
+    }
+    cqRing = sqRing;
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqeMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (sqeMap == MAP_FAILED) {
+        LOG_ERROR("io_uring sqe mmap failed: " << std::strerror(errno));
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqeMap);
+
+    char* sq = static_cast<char*>(sqRing);
+    sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sqEntries = params.sq_entries;
+
+    char* cq = static_cast<char*>(cqRing);
+    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // Register the read buffer pool; without it every read uses a heap buffer
+    fixedBuffers.resize(FIXED_BUFFER_SIZE * FIXED_BUFFER_COUNT);
+    std::vector<iovec> iovecs(FIXED_BUFFER_COUNT);
+    for (int i = 0; i < FIXED_BUFFER_COUNT; ++i) {
+        iovecs[i].iov_base = fixedBuffers.data() + i * FIXED_BUFFER_SIZE;
+        iovecs[i].iov_len = FIXED_BUFFER_SIZE;
+    }
+    if (sysRegister(ringFd, IORING_REGISTER_BUFFERS, iovecs.data(), FIXED_BUFFER_COUNT) == 0) {
+        for (int i = FIXED_BUFFER_COUNT - 1; i >= 0; --i) freeSlots.push_back(i);
+    } else {
+        LOG_WARN("io_uring buffer registration failed (" << std::strerror(errno) << "), using unregistered reads");
+        fixedBuffers.clear();
+    }
+
+    LOG_INFO("Server is listening on port " << port << " (io_uring)");
+    return true;
+}
+
+io_uring_sqe* UringBackend::nextSqe() {
+    unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    unsigned tail = *sqTail;
+    if (tail - head >= sqEntries) {
+        submitAndWait(0); // Ring full: hand what we have to the kernel
+        head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    }
+
+    unsigned index = tail & *sqMask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    pendingSubmit++;
+    return sqe;
+}
+
+void UringBackend::submitAndWait(unsigned minComplete) {
+    unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    while (true) {
+        int submitted = sysEnter(ringFd, pendingSubmit, minComplete, flags);
+        if (submitted >= 0) {
+            pendingSubmit -= std::min<unsigned>(pendingSubmit, submitted);
+            return;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EBUSY) {
+            // Completion queue backed up: reap before submitting more
+            if (pendingSubmit == 0 || minComplete > 0) return;
+            flags = IORING_ENTER_GETEVENTS;
+            minComplete = 1;
+            continue;
+        }
+        LOG_ERROR("io_uring_enter failed: " << std::strerror(errno));
+        return;
+    }
+}
+
+void UringBackend::armAccept() {
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listenFd;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    if (multishotAccept) sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = OP_ACCEPT;
+}
+
+void UringBackend::armWake() {
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wakeFd;
+    sqe->addr = reinterpret_cast<uint64_t>(&wakeValue);
+    sqe->len = sizeof(wakeValue);
+    sqe->user_data = OP_WAKE;
+}
+
+void UringBackend::opStarted(UringConnection* conn) {
+    if (conn->inFlight++ == 0) {
+        conn->keepAlive = conn->shared_from_this();
+    }
+}
+
+void UringBackend::opFinished(UringConnection* conn) {
+    if (--conn->inFlight == 0) {
+        // May destroy conn (and close its socket) if nobody else holds it
+        std::shared_ptr<Connection> release = std::move(conn->keepAlive);
+    }
+}
+
+void UringBackend::armRead(UringConnection* conn) {
+    io_uring_sqe* sqe = nextSqe();
+    sqe->fd = conn->fd();
+    if (conn->readSlot >= 0) {
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->addr = reinterpret_cast<uint64_t>(fixedBuffers.data() + conn->readSlot * FIXED_BUFFER_SIZE);
+        sqe->len = FIXED_BUFFER_SIZE;
+        sqe->buf_index = static_cast<uint16_t>(conn->readSlot);
+    } else {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->addr = reinterpret_cast<uint64_t>(conn->readBuf.data());
+        sqe->len = static_cast<unsigned>(conn->readBuf.size());
+    }
+    sqe->user_data = reinterpret_cast<uint64_t>(conn) | OP_READ;
+    opStarted(conn);
+}
+
+void UringBackend::armWrite(UringConnection* conn) {
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = conn->fd();
+    sqe->addr = reinterpret_cast<uint64_t>(conn->writeBuf.data() + conn->writeOffset);
+    sqe->len = static_cast<unsigned>(conn->writeBuf.size() - conn->writeOffset);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = reinterpret_cast<uint64_t>(conn) | OP_WRITE;
+    conn->writing = true;
+    opStarted(conn);
+}
+
+void UringBackend::run() {
+    armAccept();
+    armWake();
+
+    while (!stopping.load(std::memory_order_acquire)) {
+        submitAndWait(1);
+
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            io_uring_cqe cqe = cqes[head & *cqMask];
+            head++;
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+            uint64_t op = cqe.user_data & OP_MASK;
+            UringConnection* conn = reinterpret_cast<UringConnection*>(cqe.user_data & ~OP_MASK);
+            switch (op) {
+                case OP_ACCEPT: onAccept(cqe); break;
+                case OP_WAKE:
+                    drainWriteQueue();
+                    {
+                        std::vector<std::shared_ptr<UringConnection>> retry(paused.begin(), paused.end());
+                        for (const auto& pausedConn : retry) retryPaused(pausedConn.get());
+                        std::vector<std::shared_ptr<UringConnection>> recheck(closing.begin(), closing.end());
+                        for (const auto& closingConn : recheck) finishClosing(closingConn.get());
+                    }
+                    if (!stopping.load(std::memory_order_acquire)) armWake();
+                    break;
+                case OP_READ: onRead(conn, cqe.res); break;
+                case OP_WRITE: onWrite(conn, cqe.res); break;
+                default: break;
+            }
+            tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    for (const auto& conn : connections) {
+        conn->markClosed();
+        handler.onDisconnect(conn);
+    }
+    connections.clear();
+    paused.clear();
+    closing.clear();
+}
+
+void UringBackend::stop() {
+    stopping.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    if (wakeFd != -1 && write(wakeFd, &one, sizeof(one)) < 0) {
+        // Counter already non-zero: the loop is waking anyway
+    }
+}
+
+void UringBackend::recheckConnections() {
+    uint64_t one = 1;
+    if (wakeFd != -1 && write(wakeFd, &one, sizeof(one)) < 0) {
+        // Counter already non-zero: the loop is waking anyway
+    }
+}
+
+void UringBackend::queueWrite(std::shared_ptr<UringConnection> conn) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(writeQueueMutex);
+        wake = writeQueue.empty(); // One eventfd write per batch
+        writeQueue.push_back(std::move(conn));
+    }
+    uint64_t one = 1;
+    if (wake && write(wakeFd, &one, sizeof(one)) < 0) {
+        // Counter already non-zero: the loop is waking anyway
+    }
+}
+
+void UringBackend::drainWriteQueue() {
+    std::vector<std::shared_ptr<UringConnection>> batch;
+    {
+        std::lock_guard<std::mutex> lock(writeQueueMutex);
+        batch.swap(writeQueue);
+    }
+
+    // Every send queued since the last wakeup goes out in the next submit
+    for (const auto& conn : batch) {
+        conn->writeQueued.store(false);
+        if (!conn->writing && conn->takeOutput(conn->writeBuf)) {
+            conn->writeOffset = 0;
+            armWrite(conn.get());
+        }
+    }
+}
+
+void UringBackend::onAccept(const io_uring_cqe& cqe) {
+    bool more = cqe.flags & IORING_CQE_F_MORE;
+
+    if (cqe.res >= 0) {
+        int client_fd = cqe.res;
+        int nodelay = 1;
+        setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        auto conn = std::make_shared<UringConnection>(client_fd, *this);
+        if (!freeSlots.empty()) {
+            conn->readSlot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            conn->readBuf.resize(HEAP_BUFFER_SIZE);
+        }
+        connections.insert(conn);
+        LOG_INFO("Accepted client connection. Client FD: " << client_fd);
+        handler.onConnect(conn);
+        armRead(conn.get());
+    } else if (cqe.res == -EINVAL && multishotAccept) {
+        LOG_INFO("Multishot accept not supported, re-arming single accepts");
+        multishotAccept = false;
+    } else if (cqe.res != -EINTR && cqe.res != -EAGAIN) {
+        LOG_ERROR("accept failed: " << std::strerror(-cqe.res));
+    }
+
+    if (!more && !stopping.load(std::memory_order_acquire)) {
+        armAccept();
+    }
+}
+
+void UringBackend::onRead(UringConnection* conn, int result) {
+    if (result > 0) {
+        const char* data = conn->readSlot >= 0
+            ? fixedBuffers.data() + conn->readSlot * FIXED_BUFFER_SIZE
+            : conn->readBuf.data();
+        conn->inBuf.append(data, result);
+        std::shared_ptr<UringConnection> self = std::static_pointer_cast<UringConnection>(conn->shared_from_this());
+        if (handler.onData(self)) {
+            armRead(conn);
+        } else {
+            conn->readPaused = true; // Read again after a retry
+            paused.insert(self);
+        }
+    } else if (result == -EINTR || result == -EAGAIN) {
+        armRead(conn);
+    } else if (result == 0) {
+        LOG_INFO("Client disconnected. Client FD: " << conn->fd());
+        closeRead(conn, false);
+    } else {
+        LOG_ERROR("Failed to read from fd " << conn->fd() << ": " << std::strerror(-result));
+        closeRead(conn, true);
+    }
+    opFinished(conn);
+}
+
+void UringBackend::onWrite(UringConnection* conn, int result) {
+    conn->writing = false;
+
+    if (result > 0) {
+        conn->writeOffset += result;
+    } else if (result != -EINTR && result != -EAGAIN) {
+        LOG_ERROR("Failed to write to client (FD: " << conn->fd() << "): " << std::strerror(-result));
+        conn->markClosed();
+        conn->writeBuf.clear();
+        conn->writeOffset = 0;
+    }
+
+    if (conn->writeOffset < conn->writeBuf.size()) {
+        armWrite(conn); // Short write: send the rest
+    } else {
+        conn->writeBuf.clear();
+        conn->writeOffset = 0;
+        if (conn->takeOutput(conn->writeBuf)) armWrite(conn);
+    }
+    retryPaused(conn);
+    finishClosing(conn);
+    opFinished(conn);
+}
+
+void UringBackend::retryPaused(UringConnection* conn) {
+    if (!conn->readPaused) return;
+    std::shared_ptr<UringConnection> self = std::static_pointer_cast<UringConnection>(conn->shared_from_this());
+    if (handler.onData(self)) {
+        conn->readPaused = false;
+        paused.erase(self);
+        armRead(conn);
+    }
+}
+
+void UringBackend::closeRead(UringConnection* conn, bool failed) {
+    // The socket closes when the last owner (session, task or in-flight op)
+    // drops it. After a clean EOF the client may only have half-closed, so
+    // the connection stays until the replies to its last commands are out.
+    conn->readOpen = false;
+    if (failed) conn->markClosed();
+    if (conn->readSlot >= 0) {
+        freeSlots.push_back(conn->readSlot);
+        conn->readSlot = -1;
+    }
+
+    std::shared_ptr<UringConnection> self = std::static_pointer_cast<UringConnection>(conn->shared_from_this());
+    if (failed) {
+        handler.onDisconnect(self);
+        connections.erase(self);
+        return;
+    }
+    closing.insert(self);
+    handler.onInputClosed(self);
+    finishClosing(conn);
+}
+
+void UringBackend::finishClosing(UringConnection* conn) {
+    if (conn->readOpen) return;
+    std::shared_ptr<UringConnection> self = std::static_pointer_cast<UringConnection>(conn->shared_from_this());
+    // Pipeline work first: replies it still sends would land in outBuf
+    if (closing.count(self) && !handler.hasPendingWork(self) && !conn->writing && conn->pendingOutput() == 0) {
+        closing.erase(self);
+        handler.onDisconnect(self);
+        connections.erase(self);
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef URING_BACKEND_HPP
+#define URING_BACKEND_HPP
+
+#include "io_backend.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+class UringConnection;
+
+// io_uring event loop built on the raw syscalls (no liburing). Clients are
+// accepted with a multishot accept, reads land in buffers registered with the
+// ring (READ_FIXED) while slots last, and writes queued from any thread are
+// collected and submitted to the kernel in one batch per loop iteration.
+// A connection the handler paused gets no new read until a retry succeeds.
+// After EOF a connection is kept until its replies have gone out.
+class UringBackend : public IOBackend {
+public:
+    UringBackend(int port, ConnectionHandler& handler);
+    ~UringBackend() override;
+
+    // True if this kernel can run the backend (ring setup and required ops)
+    static bool isSupported();
+
+    bool open() override;
+    void run() override;
+    void stop() override;
+    void recheckConnections() override;
+
+    // Any thread: conn has bytes queued; picked up on the next loop iteration
+    void queueWrite(std::shared_ptr<UringConnection> conn);
+
+private:
+    io_uring_sqe* nextSqe();
+    void submitAndWait(unsigned minComplete);
+
+    void armAccept();
+    void armWake();
+    void armRead(UringConnection* conn);
+    void armWrite(UringConnection* conn);
+    void opStarted(UringConnection* conn);
+    void opFinished(UringConnection* conn);
+
+    void onAccept(const io_uring_cqe& cqe);
+    void onRead(UringConnection* conn, int result);
+    void onWrite(UringConnection* conn, int result);
+    void drainWriteQueue();
+    void closeRead(UringConnection* conn, bool failed);
+    void retryPaused(UringConnection* conn);
+    void finishClosing(UringConnection* conn);
+
+    int port;
+    ConnectionHandler& handler;
+    int listenFd;
+    int wakeFd; // eventfd read through the ring; written by stop()/queueWrite()/recheckConnections()
+    uint64_t wakeValue;
+    std::atomic<bool> stopping;
+    bool multishotAccept;
+
+    // Ring mappings
+    int ringFd;
+    void* sqRing;
+    size_t sqRingSize;
+    void* cqRing;
+    size_t cqRingSize;
+    io_uring_sqe* sqes;
+    size_t sqesSize;
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    unsigned sqEntries;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    io_uring_cqe* cqes;
+    unsigned pendingSubmit;
+
+    // Registered read buffers; slots are handed to connections on accept
+    std::vector<char> fixedBuffers;
+    std::vector<int> freeSlots;
+
+    // Live connections, those whose reading onData paused and those past EOF
+    // waiting for their replies (loop thread only)
+    std::unordered_set<std::shared_ptr<UringConnection>> connections;
+    std::unordered_set<std::shared_ptr<UringConnection>> paused;
+    std::unordered_set<std::shared_ptr<UringConnection>> closing;
+
+    // Connections with output queued from other threads
+    std::mutex writeQueueMutex;
+    std::vector<std::shared_ptr<UringConnection>> writeQueue;
+};
+
+#endif // URING_BACKEND_HPP
@@ -0,0 +1,60 @@
+#include "weight_kernels.hpp"
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+int64_t sumWeights(const int* weights, size_t n) {
+    size_t i = 0;
+    int64_t sum = 0;
+#ifdef __SSE2__
+    // Widen each group of four int32 to int64 (sign from an arithmetic
+    // shift) and keep two 64-bit lane sums
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        __m128i sign = _mm_srai_epi32(x, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(x, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(x, sign));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    sum = lanes[0] + lanes[1];
+#endif
+    for (; i < n; ++i) {
+        sum += weights[i];
+    }
+    return sum;
+}
+
+void minMaxWeight(const int* weights, size_t n, int& minWeight, int& maxWeight) {
+    size_t i = 0;
+    int low = weights[0];
+    int high = weights[0];
+#ifdef __SSE2__
+    if (n >= 4) {
+        // SSE2 has no 32-bit min/max: select through a compare mask
+        __m128i lows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights));
+        __m128i highs = lows;
+        for (i = 4; i + 4 <= n; i += 4) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+            __m128i less = _mm_cmplt_epi32(x, lows);
+            lows = _mm_or_si128(_mm_and_si128(less, x), _mm_andnot_si128(less, lows));
+            __m128i greater = _mm_cmpgt_epi32(x, highs);
+            highs = _mm_or_si128(_mm_and_si128(greater, x), _mm_andnot_si128(greater, highs));
+        }
+        int lowLanes[4], highLanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lowLanes), lows);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(highLanes), highs);
+        low = *std::min_element(lowLanes, lowLanes + 4);
+        high = *std::max_element(highLanes, highLanes + 4);
+    }
+#endif
+    for (; i < n; ++i) {
+        low = std::min(low, weights[i]);
+        high = std::max(high, weights[i]);
+    }
+    minWeight = low;
+    maxWeight = high;
+}
@@ -0,0 +1,17 @@
+#ifndef WEIGHT_KERNELS_HPP
+#define WEIGHT_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Reductions over a contiguous array of edge weights (EdgeArrays::weight),
+// four lanes at a time with SSE2 where available. Reading a plain int array
+// moves a third of the bytes that the same loop over Edge structs does.
+
+// Sum in 64 bits, so large trees do not overflow
+int64_t sumWeights(const int* weights, size_t n);
+
+// Smallest and largest weight; n must be at least 1
+void minMaxWeight(const int* weights, size_t n, int& minWeight, int& maxWeight);
+
+#endif // WEIGHT_KERNELS_HPP
@@ -0,0 +1,107 @@
+#ifndef WORK_STEALING_DEQUE_HPP
+#define WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Chase-Lev work-stealing deque of T* (Chase & Lev 2005, with the C11
+// memory orderings of Le, Pop, Cohen & Zappa Nardelli 2013). The owning
+// thread pushes and pops at the bottom; any thread may steal from the top.
+// The buffer grows on demand; outgrown buffers are kept until destruction
+// because a concurrent thief may still be reading them.
+template <typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(int64_t capacity = 256)
+        : top(0), bottom(0), buffer(new Buffer(capacity)) {}
+
+    ~WorkStealingDeque() { delete buffer.load(std::memory_order_relaxed); }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only
+    void push(T* item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Buffer* buf = buffer.load(std::memory_order_relaxed);
+        if (b - t > buf->capacity - 1) {
+            buf = grow(buf, t, b);
+        }
+        buf->put(b, item);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only; nullptr if empty
+    T* pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* buf = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T* item = buf->get(b);
+        if (t == b) {
+            // Last item: race the thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread; nullptr if empty or another thread won the race
+    T* steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        Buffer* buf = buffer.load(std::memory_order_acquire);
+        T* item = buf->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(int64_t capacity) : capacity(capacity), mask(capacity - 1), slots(new std::atomic<T*>[capacity]) {}
+
+        T* get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T* item) { slots[i & mask].store(item, std::memory_order_relaxed); }
+
+        int64_t capacity; // Power of two
+        int64_t mask;
+        std::unique_ptr<std::atomic<T*>[]> slots;
+    };
+
+    Buffer* grow(Buffer* old, int64_t t, int64_t b) {
+        Buffer* bigger = new Buffer(old->capacity * 2);
+        for (int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        retired.emplace_back(old);
+        buffer.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<Buffer*> buffer;
+    std::vector<std::unique_ptr<Buffer>> retired; // Owner only
+};
+
+#endif // WORK_STEALING_DEQUE_HPP